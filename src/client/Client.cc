@@ -48,6 +48,7 @@
 #include "mon/MonClient.h"
 
 #include "messages/MClientCaps.h"
+#include "messages/MClientCapsBatch.h"
 #include "messages/MClientLease.h"
 #include "messages/MClientQuota.h"
 #include "messages/MClientReclaim.h"
@@ -2604,6 +2605,9 @@ bool Client::ms_dispatch2(const MessageRef &m)
   case CEPH_MSG_CLIENT_CAPS:
     handle_caps(ref_cast<MClientCaps>(m));
     break;
+  case CEPH_MSG_CLIENT_CAPS_BATCH:
+    handle_caps_batch(ref_cast<MClientCapsBatch>(m));
+    break;
   case CEPH_MSG_CLIENT_LEASE:
     handle_lease(ref_cast<MClientLease>(m));
     break;
@@ -4882,6 +4886,16 @@ void Client::handle_caps(const MConstRef<MClientCaps>& m)
   }
 }
 
+void Client::handle_caps_batch(const MConstRef<MClientCapsBatch>& m)
+{
+  ldout(cct, 10) << __func__ << " " << m->caps.size() << " caps from "
+		 << m->get_source() << dendl;
+  for (auto& c : m->caps) {
+    c->set_connection(m->get_connection());
+    handle_caps(c);
+  }
+}
+
 void Client::handle_cap_import(MetaSession *session, Inode *in, const MConstRef<MClientCaps>& m)
 {
   mds_rank_t mds = session->mds_num;
@@ -665,6 +665,7 @@ public:
   void handle_quota(const MConstRef<MClientQuota>& m);
   void handle_snap(const MConstRef<MClientSnap>& m);
   void handle_caps(const MConstRef<MClientCaps>& m);
+  void handle_caps_batch(const MConstRef<MClientCapsBatch>& m);
   void handle_cap_import(MetaSession *session, Inode *in, const MConstRef<MClientCaps>& m);
   void handle_cap_export(MetaSession *session, Inode *in, const MConstRef<MClientCaps>& m);
   void handle_cap_trunc(MetaSession *session, Inode *in, const MConstRef<MClientCaps>& m);
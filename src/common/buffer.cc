@@ -12,6 +12,8 @@
  * 
  */
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <cstring>
 #include <errno.h>
@@ -70,6 +72,230 @@ static ceph::spinlock debug_lock;
     return buffer_missed_crc;
   }
 
+  /*
+   * Per-thread pool of page-aligned data buffers from 4K to 4M, kept
+   * in power-of-two size classes.  Message payloads are allocated and
+   * freed at a high rate, and recycling their memory avoids going
+   * through posix_memalign()/free() and the allocator's page heap each
+   * time.  A buffer goes back to the pool of the thread that allocated
+   * it: straight onto its free lists when that thread frees it, or onto
+   * a lock-free list the owner collects from when it runs short if
+   * another thread does (e.g. rx buffers read by a messenger thread and
+   * released by an OSD op thread).  Each thread keeps at most
+   * pool_thread_max_bytes on its free lists, and as much again freed to
+   * it by other threads; anything beyond that is freed.  Idle pooled
+   * memory, and the rounding slack of pooled buffers in use, are
+   * accounted in mempool buffer_pool.
+   */
+  static std::atomic<size_t> pool_thread_max_bytes {
+    static_cast<size_t>(std::max(0, get_env_int("CEPH_BUFFER_POOL_MAX_BYTES")))
+  };
+
+  // bumped on every limit change, so that threads trim their pools
+  static std::atomic<unsigned> pool_limit_epoch {0};
+
+  void buffer::set_pool_thread_max_bytes(size_t bytes) {
+    pool_thread_max_bytes = bytes;
+    pool_limit_epoch++;
+  }
+
+  namespace {
+  constexpr unsigned POOL_MIN_SHIFT = 12;  // 4K
+  constexpr unsigned POOL_MAX_SHIFT = 22;  // 4M
+  constexpr unsigned POOL_NUM_CLASSES = POOL_MAX_SHIFT - POOL_MIN_SHIFT + 1;
+
+  size_t pool_class_size(int c) {
+    return 1ul << (c + POOL_MIN_SHIFT);
+  }
+  void pool_account(int items, ssize_t bytes) {
+    mempool::get_pool(mempool::mempool_buffer_pool).adjust_count(
+      items, bytes);
+  }
+
+  // Buffers freed to a pool by threads other than its owner.  Shared by
+  // the owner and every pooled buffer it handed out, so that it outlives
+  // the owning thread until the last of them is freed.
+  class buffer_pool_remote {
+    struct node_t {  // placed in the freed buffer itself
+      node_t *next;
+      int c;
+    };
+    std::atomic<unsigned> nref {1};  // owner + pooled buffers in use
+    std::atomic<node_t*> head {nullptr};
+    std::atomic<size_t> bytes {0};
+
+    void unaccount(int c) {
+      bytes.fetch_sub(pool_class_size(c), std::memory_order_relaxed);
+      pool_account(-1, -(ssize_t)pool_class_size(c));
+    }
+
+  public:
+    std::atomic<bool> owner_gone {false};
+
+    void get() {
+      nref.fetch_add(1, std::memory_order_relaxed);
+    }
+    void put() {
+      if (nref.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+	drain([](int, char *p) { ::free(p); });
+	delete this;
+      }
+    }
+
+    // from any thread; false if the caller should free the buffer instead
+    bool push(int c, char *p) {
+      if (owner_gone.load(std::memory_order_acquire) ||
+	  bytes.load(std::memory_order_relaxed) + pool_class_size(c) >
+	  pool_thread_max_bytes.load(std::memory_order_relaxed)) {
+	return false;
+      }
+      bytes.fetch_add(pool_class_size(c), std::memory_order_relaxed);
+      pool_account(1, pool_class_size(c));
+      auto n = reinterpret_cast<node_t*>(p);
+      n->c = c;
+      n->next = head.load(std::memory_order_relaxed);
+      while (!head.compare_exchange_weak(n->next, n,
+					 std::memory_order_release,
+					 std::memory_order_relaxed)) {
+      }
+      return true;
+    }
+
+    bool empty() const {
+      return !head.load(std::memory_order_relaxed);
+    }
+
+    // Hand every buffer on the list to f(c, p).  Only the owner (or the
+    // last reference) takes from the list, and always all of it at once,
+    // so there is no ABA to worry about.
+    template <typename F>
+    void drain(F&& f) {
+      for (auto n = head.exchange(nullptr, std::memory_order_acquire); n; ) {
+	auto next = n->next;
+	const int c = n->c;
+	unaccount(c);
+	f(c, reinterpret_cast<char*>(n));
+	n = next;
+      }
+    }
+  };
+
+  class buffer_pool {
+    std::array<std::vector<char*>, POOL_NUM_CLASSES> free_lists;
+    size_t bytes = 0;
+    buffer_pool_remote *remote = new buffer_pool_remote;
+
+    // take in what other threads freed to us
+    void collect() {
+      remote->drain([this](int c, char *p) {
+	if (!put(c, p)) {
+	  ::free(p);
+	}
+      });
+    }
+
+  public:
+    ~buffer_pool() {
+      for (unsigned c = 0; c < POOL_NUM_CLASSES; ++c) {
+	for (auto p : free_lists[c]) {
+	  ::free(p);
+	}
+	pool_account(-(int)free_lists[c].size(),
+		     -(ssize_t)(free_lists[c].size() * pool_class_size(c)));
+      }
+      destroyed = true;
+      remote->owner_gone.store(true, std::memory_order_release);
+      remote->drain([](int, char *p) { ::free(p); });
+      remote->put();
+    }
+
+    // size class that serves len, or -1 to bypass the pool
+    static int size_class(size_t len) {
+      if (len < (1ul << POOL_MIN_SHIFT) || len > (1ul << POOL_MAX_SHIFT) ||
+	  !pool_thread_max_bytes.load(std::memory_order_relaxed)) {
+	return -1;
+      }
+      unsigned shift = POOL_MIN_SHIFT;
+      while ((1ul << shift) < len) {
+	++shift;
+      }
+      // don't round up by more than a quarter
+      if ((1ul << shift) - len > len / 4) {
+	return -1;
+      }
+      return shift - POOL_MIN_SHIFT;
+    }
+    static size_t class_size(int c) {
+      return pool_class_size(c);
+    }
+
+    buffer_pool_remote *get_remote() {
+      return remote;
+    }
+
+    char *get(int c) {
+      auto& l = free_lists[c];
+      if (l.empty() && !remote->empty()) {
+	collect();
+      }
+      if (l.empty()) {
+	return nullptr;
+      }
+      char *p = l.back();
+      l.pop_back();
+      bytes -= class_size(c);
+      pool_account(-1, -(ssize_t)class_size(c));
+      return p;
+    }
+    bool put(int c, char *p) {
+      if (bytes + class_size(c) >
+	  pool_thread_max_bytes.load(std::memory_order_relaxed)) {
+	return false;
+      }
+      free_lists[c].push_back(p);
+      bytes += class_size(c);
+      pool_account(1, class_size(c));
+      return true;
+    }
+
+    // free what is over the limit, largest buffers first
+    void trim() {
+      collect();
+      const size_t max = pool_thread_max_bytes.load(std::memory_order_relaxed);
+      for (int c = POOL_NUM_CLASSES - 1; c >= 0 && bytes > max; --c) {
+	auto& l = free_lists[c];
+	while (!l.empty() && bytes > max) {
+	  ::free(l.back());
+	  l.pop_back();
+	  bytes -= class_size(c);
+	  pool_account(-1, -(ssize_t)class_size(c));
+	}
+      }
+    }
+
+    // buffers may still be released by other thread_local destructors
+    // after ours has run; they bypass the pool.
+    static thread_local bool destroyed;
+
+    // called on every get/put; cheap unless the limit has changed since
+    // this thread last looked
+    static void maybe_trim();
+  private:
+    static thread_local unsigned seen_epoch;
+  };
+  thread_local bool buffer_pool::destroyed = false;
+  thread_local unsigned buffer_pool::seen_epoch = 0;
+  thread_local buffer_pool tls_buffer_pool;
+
+  void buffer_pool::maybe_trim() {
+    const unsigned epoch = pool_limit_epoch.load(std::memory_order_relaxed);
+    if (epoch != seen_epoch && !destroyed) {
+      seen_epoch = epoch;
+      tls_buffer_pool.trim();
+    }
+  }
+  }
+
   const char * buffer::error::what() const throw () {
     return "buffer::exception";
   }
@@ -165,26 +391,64 @@ static ceph::spinlock debug_lock;
 #ifndef __CYGWIN__
   class buffer::raw_posix_aligned : public buffer::raw {
     unsigned align;
+    int pool_class = -1;
+    buffer_pool_remote *owner = nullptr;  // pool the buffer goes back to
+    size_t slack = 0;  // allocated beyond len when pooled
   public:
     MEMPOOL_CLASS_HELPERS();
 
     raw_posix_aligned(unsigned l, unsigned _align) : raw(l) {
       align = _align;
       ceph_assert((align >= sizeof(void *)) && (align & (align - 1)) == 0);
+      size_t alloc_len = len;
+      unsigned alloc_align = align;
+      if (align <= CEPH_PAGE_SIZE && !buffer_pool::destroyed) {
+	buffer_pool::maybe_trim();
+	pool_class = buffer_pool::size_class(len);
+	if (pool_class >= 0) {
+	  data = tls_buffer_pool.get(pool_class);
+	  alloc_len = buffer_pool::class_size(pool_class);
+	  alloc_align = CEPH_PAGE_SIZE;
+	}
+      }
+      if (!data) {
 #ifdef DARWIN
-      data = (char *) valloc(len);
+	data = (char *) valloc(alloc_len);
 #else
-      int r = ::posix_memalign((void**)(void*)&data, align, len);
-      if (r)
-	throw bad_alloc();
+	int r = ::posix_memalign((void**)(void*)&data, alloc_align, alloc_len);
+	if (r)
+	  throw bad_alloc();
 #endif /* DARWIN */
+      }
       if (!data)
 	throw bad_alloc();
+      if (pool_class >= 0) {
+	owner = tls_buffer_pool.get_remote();
+	owner->get();
+	slack = alloc_len - len;
+	pool_account(0, slack);
+      }
       bdout << "raw_posix_aligned " << this << " alloc " << (void *)data
 	    << " l=" << l << ", align=" << align << bendl;
     }
     ~raw_posix_aligned() override {
-      ::free(data);
+      buffer_pool::maybe_trim();
+      if (!owner) {
+	::free(data);
+      } else {
+	pool_account(0, -(ssize_t)slack);
+	bool pooled;
+	if (!buffer_pool::destroyed &&
+	    owner == tls_buffer_pool.get_remote()) {
+	  pooled = tls_buffer_pool.put(pool_class, data);
+	} else {
+	  pooled = owner->push(pool_class, data);
+	}
+	if (!pooled) {
+	  ::free(data);
+	}
+	owner->put();
+      }
       bdout << "raw_posix_aligned " << this << " free " << (void *)data << bendl;
     }
     raw* clone_empty() override {
@@ -730,6 +994,13 @@ static ceph::spinlock debug_lock;
   void buffer::list::iterator_impl<is_const>::copy(unsigned len, char *dest)
   {
     if (p == ls->end()) seek(off);
+    // fast path: the common small decode entirely within the current ptr
+    if (p != ls->end() && p_off + len < p->length()) {
+      maybe_inline_memcpy(dest, p->c_str() + p_off, len, 16);
+      p_off += len;
+      off += len;
+      return;
+    }
     while (len > 0) {
       if (p == ls->end())
 	throw end_of_buffer();
@@ -2140,6 +2411,50 @@ buffer::ptr_node::create_hypercombined(ceph::unique_leakable_ptr<buffer::raw> r)
     new ptr_node(std::move(r)));
 }
 
+namespace {
+struct ptr_node_cache {
+  static constexpr size_t MAX_NODES = 256;
+  void *nodes[MAX_NODES];
+  size_t num = 0;
+
+  ~ptr_node_cache() {
+    while (num) {
+      ::operator delete(nodes[--num]);
+    }
+    destroyed = true;
+  }
+  // nodes may still be freed by other thread_local destructors after
+  // ours has run; they go straight to the heap.
+  static thread_local bool destroyed;
+};
+thread_local bool ptr_node_cache::destroyed = false;
+thread_local ptr_node_cache tls_ptr_node_cache;
+}
+
+void* buffer::ptr_node::operator new(size_t size)
+{
+  if (size == sizeof(ptr_node) && !ptr_node_cache::destroyed) {
+    auto& cache = tls_ptr_node_cache;
+    if (cache.num) {
+      return cache.nodes[--cache.num];
+    }
+  }
+  return ::operator new(size);
+}
+
+void buffer::ptr_node::operator delete(void* p)
+{
+  // ptr_node is never subclassed, so every node here is sizeof(ptr_node)
+  if (!ptr_node_cache::destroyed) {
+    auto& cache = tls_ptr_node_cache;
+    if (cache.num < ptr_node_cache::MAX_NODES) {
+      cache.nodes[cache.num++] = p;
+      return;
+    }
+  }
+  ::operator delete(p);
+}
+
 buffer::ptr_node* buffer::ptr_node::cloner::operator()(
   const buffer::ptr_node& clone_this)
 {
@@ -153,6 +153,7 @@ public:
   const char** get_tracked_conf_keys() const override {
     static const char *KEYS[] = {
       "mempool_debug",
+      "buffer_pool_thread_max_bytes",
       NULL
     };
     return KEYS;
@@ -164,6 +165,10 @@ public:
     if (changed.count("mempool_debug")) {
       mempool::set_debug_mode(cct->_conf->mempool_debug);
     }
+    if (changed.count("buffer_pool_thread_max_bytes")) {
+      ceph::buffer::set_pool_thread_max_bytes(
+	cct->_conf.get_val<Option::size_t>("buffer_pool_thread_max_bytes"));
+    }
   }
 
   // AdminSocketHook
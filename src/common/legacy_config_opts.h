@@ -386,6 +386,7 @@ OPTION(objecter_inflight_ops, OPT_U64)               // max in-flight ios
 OPTION(objecter_completion_locks_per_session, OPT_U64) // num of completion locks per each session, for serializing same object responses
 OPTION(objecter_inject_no_watch_ping, OPT_BOOL)   // suppress watch pings
 OPTION(objecter_retry_writes_after_first_reply, OPT_BOOL)   // ignore the first reply for each write, and resend the osd op instead
+OPTION(objecter_balance_reads_by_load, OPT_BOOL)  // balanced reads go to the least loaded replica
 OPTION(objecter_debug_inject_relock_delay, OPT_BOOL)
 
 // Max number of deletes at once in a single Filer::purge call
@@ -651,6 +652,7 @@ OPTION(osd_heartbeat_grace, OPT_INT)
 OPTION(osd_heartbeat_min_peers, OPT_INT)     // minimum number of peers
 OPTION(osd_heartbeat_use_min_delay_socket, OPT_BOOL) // prio the heartbeat tcp socket and set dscp as CS6 on it if true
 OPTION(osd_heartbeat_min_size, OPT_INT) // the minimum size of OSD heartbeat messages to send
+OPTION(osd_heartbeat_piggyback, OPT_BOOL) // credit back heartbeats from cluster traffic
 
 // max number of parallel snap trims/pg
 OPTION(osd_pg_max_concurrent_snap_trims, OPT_U64)
@@ -706,6 +708,7 @@ OPTION(osd_deep_scrub_stride, OPT_INT)
 OPTION(osd_deep_scrub_keys, OPT_INT)
 OPTION(osd_deep_scrub_update_digest_min_age, OPT_INT)   // objects must be this old (seconds) before we update the whole-object digest on scrub
 OPTION(osd_skip_data_digest, OPT_BOOL)
+OPTION(osd_fast_read_path, OPT_BOOL)
 OPTION(osd_deep_scrub_large_omap_object_key_threshold, OPT_U64)
 OPTION(osd_deep_scrub_large_omap_object_value_sum_threshold, OPT_U64)
 OPTION(osd_class_dir, OPT_STR) // where rados plugins are stored
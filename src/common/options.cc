@@ -797,6 +797,11 @@ std::vector<Option> get_global_options() {
     .set_flag(Option::FLAG_NO_MON_UPDATE)
     .set_description(""),
 
+    Option("buffer_pool_thread_max_bytes", Option::TYPE_SIZE, Option::LEVEL_ADVANCED)
+    .set_default(0)
+    .set_description("Freed 4K-4M page-aligned buffers each thread may keep for reuse (0 disables)")
+    .set_long_description("Large message and data buffers are recycled through per-thread size-class pools instead of going back to the allocator. Idle pooled memory is reported in the buffer_pool mempool. A few tens of MB is a reasonable value for OSDs."),
+
     Option("thp", Option::TYPE_BOOL, Option::LEVEL_DEV)
     .set_default(false)
     .set_flag(Option::FLAG_STARTUP)
@@ -1124,6 +1129,77 @@ std::vector<Option> get_global_options() {
     .set_description("Maximum threadpool size of AsyncMessenger")
     .add_see_also("ms_async_op_threads"),
 
+    Option("ms_async_affinity_cores", Option::TYPE_STR, Option::LEVEL_ADVANCED)
+    .set_default("")
+    .set_flag(Option::FLAG_STARTUP)
+    .set_description("Run one AsyncMessenger worker per listed CPU, pinned to it")
+    .set_long_description("A CPU list such as '0-3,8'. When set, the number of workers is the number of listed CPUs (ms_async_op_threads is ignored) and worker N is pinned to the Nth CPU, so that memory it first touches is NUMA-local to it.")
+    .add_see_also("ms_async_op_threads")
+    .add_see_also("ms_async_reuseport"),
+
+    Option("ms_async_reuseport", Option::TYPE_BOOL, Option::LEVEL_ADVANCED)
+    .set_default(false)
+    .set_flag(Option::FLAG_STARTUP)
+    .set_description("Give every posix AsyncMessenger worker its own SO_REUSEPORT listening socket")
+    .set_long_description("The kernel then spreads incoming connections over the workers, and each accepted connection is served by the worker that accepted it instead of being handed to another one.")
+    .add_see_also("ms_async_affinity_cores"),
+
+    Option("ms_async_zerocopy_min_size", Option::TYPE_SIZE, Option::LEVEL_ADVANCED)
+    .set_default(0)
+    .set_description("Send writes of at least this many bytes with MSG_ZEROCOPY (0 disables)")
+    .set_long_description("Only used by the posix stack on kernels supporting SO_ZEROCOPY. The kernel transmits straight from the message buffers, which are held until the kernel reports completion on the socket error queue. Zero-copy has a fixed per-call cost, so it only pays off for large payloads, typically 64K and above."),
+
+    Option("ms_async_cork_max_bytes", Option::TYPE_SIZE, Option::LEVEL_ADVANCED)
+    .set_default(64_K)
+    .set_description("Coalesce queued outgoing messages into a single socket write up to this many bytes (0 disables)")
+    .set_long_description("When more messages are already queued behind the one being encoded, the msgr2 protocol holds back the socket write so the whole backlog goes out with one sendmsg. A lone message is still sent immediately, so this only adds latency when the connection is already busy.")
+    .set_flag(Option::FLAG_STARTUP)
+    .add_see_also("ms_async_cork_max_us"),
+
+    Option("ms_async_cork_max_us", Option::TYPE_UINT, Option::LEVEL_ADVANCED)
+    .set_default(100)
+    .set_flag(Option::FLAG_STARTUP)
+    .set_description("Maximum time in microseconds a queued outgoing message may be held back while coalescing writes")
+    .add_see_also("ms_async_cork_max_bytes"),
+
+    Option("ms_compress_mode", Option::TYPE_STR, Option::LEVEL_ADVANCED)
+    .set_default("none")
+    .set_enum_allowed({"none", "force"})
+    .set_description("Compress msgr2 message frames sent to peers that support it")
+    .set_long_description("Applies to new connections between entities listed in ms_compress_entity_types. Front, middle and data segments of at least ms_compress_min_size bytes are compressed with ms_compress_algorithm; segments that do not shrink are sent as they are.")
+    .add_see_also("ms_compress_entity_types")
+    .add_see_also("ms_compress_algorithm")
+    .add_see_also("ms_compress_min_size"),
+
+    Option("ms_compress_entity_types", Option::TYPE_STR, Option::LEVEL_ADVANCED)
+    .set_default("osd")
+    .set_description("Entity types whose connections are compressed")
+    .set_long_description("A connection is compressed only if both the local and the peer entity type are listed, so the default only compresses osd<->osd traffic (replication and recovery).")
+    .add_see_also("ms_compress_mode"),
+
+    Option("ms_compress_algorithm", Option::TYPE_STR, Option::LEVEL_ADVANCED)
+    .set_default("snappy")
+    .set_enum_allowed({"snappy", "zlib", "zstd", "lz4"})
+    .set_description("Compressor plugin used for msgr2 frame compression")
+    .add_see_also("ms_compress_mode"),
+
+    Option("ms_compress_min_size", Option::TYPE_SIZE, Option::LEVEL_ADVANCED)
+    .set_default(1024)
+    .set_description("Smallest message segment that is compressed")
+    .add_see_also("ms_compress_mode"),
+
+    Option("ms_compress_secure", Option::TYPE_BOOL, Option::LEVEL_ADVANCED)
+    .set_default(false)
+    .set_description("Allow compression on connections in secure mode")
+    .set_long_description("Compressing before encrypting can leak information about the plaintext through the ciphertext length (as in CRIME-style attacks), so secure mode connections are not compressed unless this is set.")
+    .add_see_also("ms_compress_mode"),
+
+    Option("ms_compress_max_raw_size", Option::TYPE_SIZE, Option::LEVEL_ADVANCED)
+    .set_default(256_M)
+    .set_description("Largest decompressed size accepted for a compressed message")
+    .set_long_description("A compressed message frame whose front, middle and data segments claim to decompress to more than this is rejected, and the connection faulted, before anything is decompressed. Throttles are charged with the decompressed size.")
+    .add_see_also("ms_compress_mode"),
+
     Option("ms_async_rdma_device_name", Option::TYPE_STR, Option::LEVEL_ADVANCED)
     .set_default("")
     .set_description(""),
@@ -1140,6 +1216,12 @@ std::vector<Option> get_global_options() {
     .set_default(1_K)
     .set_description(""),
 
+    Option("ms_async_rdma_max_inline_data", Option::TYPE_UINT, Option::LEVEL_ADVANCED)
+    .set_default(128)
+    .set_min_max(0, 1024)
+    .set_description("Post sends of up to this many bytes inline in the work request (0 disables)")
+    .set_long_description("Inline sends are copied into the work queue entry by the HCA, so they need no registered tx buffer and avoid a DMA read of the payload. The value is capped by what the device supports; if the queue pair cannot be created with inline data, it is created without."),
+
     Option("ms_async_rdma_receive_buffers", Option::TYPE_UINT, Option::LEVEL_ADVANCED)
     .set_default(32768)
     .set_description(""),
@@ -2338,6 +2420,11 @@ std::vector<Option> get_global_options() {
     .set_default(false)
     .set_description(""),
 
+    Option("objecter_balance_reads_by_load", Option::TYPE_BOOL, Option::LEVEL_ADVANCED)
+    .set_default(false)
+    .set_description("Send balanced reads to the least loaded replica instead of a random one")
+    .set_long_description("For ops flagged CEPH_OSD_FLAG_BALANCE_READS, estimate the load of each acting OSD from the number of ops this client has in flight to it and the read latency it has recently observed from it, and pick the cheapest."),
+
     Option("objecter_debug_inject_relock_delay", Option::TYPE_BOOL, Option::LEVEL_DEV)
     .set_default(false)
     .set_description(""),
@@ -2836,6 +2923,11 @@ std::vector<Option> get_global_options() {
     .set_default(false)
     .set_description("Do not store full-object checksums if the backend (bluestore) does its own checksums.  Only usable with all BlueStore OSDs."),
 
+    Option("osd_fast_read_path", Option::TYPE_BOOL, Option::LEVEL_ADVANCED)
+    .set_default(false)
+    .set_description("Serve single READ or STAT ops on clean head objects in replicated pools without a full op context")
+    .set_long_description("Simple reads whose object has no write in flight are answered directly from do_op, skipping OpContext setup, obc locking and do_osd_ops. Anything else, including any read error, takes the normal path. See the op_r_fast perf counters."),
+
     Option("osd_op_queue", Option::TYPE_STR, Option::LEVEL_ADVANCED)
     .set_default("wpq")
     .set_enum_allowed( { "wpq", "prioritized",
@@ -3023,6 +3115,12 @@ std::vector<Option> get_global_options() {
     .set_default(2000)
     .set_description("Minimum heartbeat packet size in bytes. Will add dummy payload if heartbeat packet is smaller than this."),
 
+    Option("osd_heartbeat_piggyback", Option::TYPE_BOOL, Option::LEVEL_ADVANCED)
+    .set_default(false)
+    .set_description("Skip the back (cluster network) ping to peers that have replied to our cluster traffic since the last heartbeat")
+    .set_long_description("A replication, EC or recovery reply from a peer shows that its cluster network path works in both directions, so the back heartbeat for that round is credited from it instead of being sent. The front ping is always sent, at most 3 rounds in a row are credited so back ping times keep being measured, and a peer that stops replying gets regular back pings again on the next round.")
+    .add_see_also("osd_heartbeat_interval"),
+
     Option("osd_pg_max_concurrent_snap_trims", Option::TYPE_UINT, Option::LEVEL_ADVANCED)
     .set_default(2)
     .set_description(""),
@@ -7627,6 +7725,23 @@ std::vector<Option> get_mds_options() {
     .set_default(16384)
     .set_description("number of directory entries to read in one RADOS operation"),
 
+    Option("mds_dir_fetch_max_inflight", Option::TYPE_UINT, Option::LEVEL_ADVANCED)
+    .set_default(64)
+    .set_description("maximum number of directory fragment fetches in flight")
+    .set_long_description("Whole-fragment directory fetches beyond this many are queued and issued as earlier ones complete, so that a burst of fetches (e.g. during rejoin) keeps the metadata pool busy without flooding it. 0 means no limit."),
+
+    Option("mds_dir_prefetch_siblings", Option::TYPE_BOOL, Option::LEVEL_ADVANCED)
+    .set_default(false)
+    .set_description("fetch the sibling fragments of a directory fragment being loaded")
+    .set_long_description("When a whole directory fragment is fetched, also fetch up to mds_dir_prefetch_siblings_max of its incomplete sibling fragments. Prefetches wait behind fetches that have waiters and use at most a quarter of mds_dir_fetch_max_inflight.")
+    .add_see_also("mds_dir_fetch_max_inflight")
+    .add_see_also("mds_dir_prefetch_siblings_max"),
+
+    Option("mds_dir_prefetch_siblings_max", Option::TYPE_UINT, Option::LEVEL_ADVANCED)
+    .set_default(4)
+    .set_description("maximum number of sibling fragments prefetched per directory fragment fetch")
+    .add_see_also("mds_dir_prefetch_siblings"),
+
     Option("mds_decay_halflife", Option::TYPE_FLOAT, Option::LEVEL_ADVANCED)
     .set_default(5)
     .set_description("rate of decay for temperature counters on each directory for balancing"),
@@ -7765,6 +7880,12 @@ std::vector<Option> get_mds_options() {
     .set_default(1024)
     .set_description("maximum number of events in an MDS journal segment"),
 
+    Option("mds_log_batch_events", Option::TYPE_UINT, Option::LEVEL_ADVANCED)
+    .set_default(128)
+    .set_min(1)
+    .set_description("maximum number of queued events the journal submit thread encodes and appends as one group")
+    .set_long_description("Events queued while the previous group was being written are appended together, and any flushes they requested are merged into a single journal flush issued after the whole group. Set to 1 to append and flush events one at a time."),
+
     Option("mds_log_segment_size", Option::TYPE_SIZE, Option::LEVEL_ADVANCED)
     .set_default(0)
     .set_description("size in bytes of each MDS log segment"),
@@ -7835,6 +7956,26 @@ std::vector<Option> get_mds_options() {
     .set_default(0)
     .set_description("idle metadata popularity threshold before rebalancing"),
 
+    Option("mds_bal_export_cost", Option::TYPE_FLOAT, Option::LEVEL_ADVANCED)
+    .set_default(0)
+    .set_min(0)
+    .set_description("estimated migration cost, in popularity units, per inode in the subtree of an export candidate")
+    .set_long_description("When the balancer has to assemble an export from dirfrags smaller than the load it needs to shed, it ranks them by their popularity minus this cost times the number of files and directories nested under the dirfrag (from its recursive stats), and skips those not worth moving. 0 ranks by popularity alone.")
+    .add_see_also("mds_bal_predict_horizon"),
+
+    Option("mds_bal_predict_horizon", Option::TYPE_FLOAT, Option::LEVEL_ADVANCED)
+    .set_default(0)
+    .set_min(0)
+    .set_description("seconds ahead for which the balancer extrapolates the load of export candidates")
+    .set_long_description("The balancer samples the decayed popularity of the smaller export candidates every time it considers them, and ranks them by the popularity expected this many seconds ahead on the current trend, so a subtree that is cooling down is preferred less than one that is heating up. Which dirfrags are candidates at all still depends on their current popularity. 0 ranks by current popularity.")
+    .add_see_also("mds_bal_export_cost"),
+
+    Option("mds_bal_import_hold", Option::TYPE_FLOAT, Option::LEVEL_ADVANCED)
+    .set_default(0)
+    .set_min(0)
+    .set_description("seconds during which a freshly imported subtree is not re-exported by the balancer")
+    .set_long_description("Prevents subtrees from bouncing back and forth between ranks when their load fluctuates around the balancing thresholds. Idle imports are still sent back to their previous rank. 0 disables the hold."),
+
     Option("mds_bal_max", Option::TYPE_INT, Option::LEVEL_DEV)
     .set_default(-1)
     .set_description(""),
@@ -7879,6 +8020,14 @@ std::vector<Option> get_mds_options() {
     .set_default(1.0)
     .set_description("time in seconds between replay of updates to journal by standby replay MDS"),
 
+    Option("mds_standby_replay_warm_cache", Option::TYPE_BOOL, Option::LEVEL_ADVANCED)
+    .set_default(false)
+    .set_flag(Option::FLAG_RUNTIME)
+    .set_description("keep replayed metadata cached in standby replay MDS")
+    .set_long_description("By default a standby-replay MDS drops cache entries as soon as the journal segments that loaded them have been expired by the active MDS. With this option it keeps them (subject to mds_cache_memory_limit), so that when it takes over, the recently-modified part of the namespace is already in cache and open file table prefetch and rejoin have less to load.")
+    .add_see_also("mds_replay_interval")
+    .add_see_also("mds_cache_memory_limit"),
+
     Option("mds_shutdown_check", Option::TYPE_INT, Option::LEVEL_DEV)
     .set_default(0)
     .set_description(""),
@@ -8043,6 +8192,14 @@ std::vector<Option> get_mds_options() {
     .set_default(8192)
     .set_description("maximum number of purge operations performed in parallel"),
 
+    Option("mds_purge_target_latency", Option::TYPE_FLOAT, Option::LEVEL_ADVANCED)
+    .set_default(0)
+    .set_min(0)
+    .set_description("target purge latency in seconds per RADOS op; adapts the purge ops limit")
+    .set_long_description("When set, the purge queue raises its limit on RADOS ops in flight while purge items complete within this latency per op they issue, and halves it when they do not, instead of using the fixed limit derived from mds_max_purge_ops_per_pg. mds_max_purge_ops remains the upper bound. 0 disables adaptation.")
+    .add_see_also("mds_max_purge_ops")
+    .add_see_also("mds_max_purge_ops_per_pg"),
+
     Option("mds_max_purge_ops_per_pg", Option::TYPE_FLOAT, Option::LEVEL_ADVANCED)
     .set_default(0.5)
     .set_description("number of parallel purge operations performed per PG"),
@@ -8063,6 +8220,12 @@ std::vector<Option> get_mds_options() {
     .set_default(5)
     .set_description("maximum number of scrub operations performed in parallel"),
 
+    Option("mds_cap_batch_interval", Option::TYPE_FLOAT, Option::LEVEL_ADVANCED)
+    .set_default(0)
+    .set_min(0)
+    .set_description("seconds to hold cap grants and revokes so they can be sent to a client as one message")
+    .set_long_description("Cap messages produced by issue_caps for clients that support batching are coalesced per session and sent together when this interval expires, or earlier if another message is sent to the same session. 0 sends every cap message on its own."),
+
     Option("mds_forward_all_requests_to_auth", Option::TYPE_BOOL, Option::LEVEL_ADVANCED)
     .set_default(false)
     .set_flag(Option::FLAG_RUNTIME)
@@ -8,6 +8,23 @@
 
 namespace ceph::buffer {
 
+seastar::future<ceph::buffer::ptr> read_file(seastar::sstring fn)
+{
+  return seastar::open_file_dma(fn, seastar::open_flags::ro).then(
+    [](seastar::file f) {
+    return f.size().then([f](uint64_t size) mutable {
+      return seastar::do_with(seastar::make_file_input_stream(std::move(f)),
+                              [size](seastar::input_stream<char>& in) {
+        return in.read_exactly(size).then([&in](auto buf) {
+          return in.close().then([buf=std::move(buf)]() mutable {
+            return ceph::buffer::ptr{ceph::buffer::create(std::move(buf))};
+          });
+        });
+      });
+    });
+  });
+}
+
 seastar::future<> write_file(ceph::buffer::list&& bl,
                              seastar::sstring fn,
                              seastar::file_permissions permissions)
@@ -9,6 +9,8 @@
 #include "include/buffer_fwd.h"
 
 namespace ceph::buffer {
+  /// read the whole file into a single buffer, without blocking the reactor
+  seastar::future<ceph::buffer::ptr> read_file(seastar::sstring fn);
   seastar::future<> write_file(ceph::buffer::list&& bl,
                                seastar::sstring fn,
                                seastar::file_permissions= // 0644
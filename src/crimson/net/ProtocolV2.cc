@@ -31,6 +31,11 @@ using namespace ceph::msgr::v2;
 
 namespace {
 
+// frame compression is not implemented here yet, so don't let peers
+// send us compressed frames
+constexpr uint64_t CRIMSON_MSGR2_SUPPORTED_FEATURES =
+  CEPH_MSGR2_SUPPORTED_FEATURES & ~CEPH_MSGR2_FEATURE_COMPRESSION;
+
 // TODO: apply the same logging policy to Protocol V1
 // Log levels in V2 Protocol:
 // * error level, something error that cause connection to terminate:
@@ -496,7 +501,7 @@ seastar::future<entity_type_t, entity_addr_t> ProtocolV2::banner_exchange()
 {
   // 1. prepare and send banner
   bufferlist banner_payload;
-  encode((uint64_t)CEPH_MSGR2_SUPPORTED_FEATURES, banner_payload, 0);
+  encode((uint64_t)CRIMSON_MSGR2_SUPPORTED_FEATURES, banner_payload, 0);
   encode((uint64_t)CEPH_MSGR2_REQUIRED_FEATURES, banner_payload, 0);
 
   bufferlist bl;
@@ -507,7 +512,7 @@ seastar::future<entity_type_t, entity_addr_t> ProtocolV2::banner_exchange()
   logger().debug("{} SEND({}) banner: len_payload={}, supported={}, "
                  "required={}, banner=\"{}\"",
                  conn, bl.length(), len_payload,
-                 CEPH_MSGR2_SUPPORTED_FEATURES, CEPH_MSGR2_REQUIRED_FEATURES,
+                 CRIMSON_MSGR2_SUPPORTED_FEATURES, CEPH_MSGR2_REQUIRED_FEATURES,
                  CEPH_BANNER_V2_PREFIX);
   INTERCEPT_CUSTOM(custom_bp_t::BANNER_WRITE, bp_type_t::WRITE);
   return write_flush(std::move(bl)).then([this] {
@@ -562,7 +567,7 @@ seastar::future<entity_type_t, entity_addr_t> ProtocolV2::banner_exchange()
                      peer_supported_features, peer_required_features);
 
       // Check feature bit compatibility
-      uint64_t supported_features = CEPH_MSGR2_SUPPORTED_FEATURES;
+      uint64_t supported_features = CRIMSON_MSGR2_SUPPORTED_FEATURES;
       uint64_t required_features = CEPH_MSGR2_REQUIRED_FEATURES;
       if ((required_features & peer_supported_features) != required_features) {
         logger().error("{} peer does not support all required features"
@@ -35,30 +35,29 @@ CyanStore::~CyanStore() = default;
 
 seastar::future<> CyanStore::mount()
 {
-  ceph::bufferlist bl;
   std::string fn = path + "/collections";
-  std::string err;
-  if (int r = bl.read_file(fn.c_str(), &err); r < 0) {
-    throw std::runtime_error("read_file");
-  }
-
-  std::set<coll_t> collections;
-  auto p = bl.cbegin();
-  ceph::decode(collections, p);
-
-  for (auto& coll : collections) {
-    std::string fn = fmt::format("{}/{}", path, coll);
-    ceph::bufferlist cbl;
-    if (int r = cbl.read_file(fn.c_str(), &err); r < 0) {
-      throw std::runtime_error("read_file");
-    }
-    boost::intrusive_ptr<Collection> c{new Collection{coll}};
-    auto p = cbl.cbegin();
-    c->decode(p);
-    coll_map[coll] = c;
-    used_bytes += c->used_bytes();
-  }
-  return seastar::now();
+  return ceph::buffer::read_file(fn).then([this](ceph::bufferptr&& bp) {
+    ceph::bufferlist bl;
+    bl.push_back(std::move(bp));
+    std::set<coll_t> collections;
+    auto p = bl.cbegin();
+    ceph::decode(collections, p);
+    return seastar::do_with(std::move(collections), [this](auto& collections) {
+      return seastar::parallel_for_each(collections, [this](auto& coll) {
+        std::string fn = fmt::format("{}/{}", path, coll);
+        return ceph::buffer::read_file(fn).then(
+          [this, coll](ceph::bufferptr&& bp) {
+          ceph::bufferlist cbl;
+          cbl.push_back(std::move(bp));
+          boost::intrusive_ptr<Collection> c{new Collection{coll}};
+          auto p = cbl.cbegin();
+          c->decode(p);
+          coll_map[coll] = c;
+          used_bytes += c->used_bytes();
+        });
+      });
+    });
+  });
 }
 
 seastar::future<> CyanStore::umount()
@@ -624,17 +623,18 @@ seastar::future<> CyanStore::write_meta(const std::string& key,
 
 seastar::future<int, std::string> CyanStore::read_meta(const std::string& key)
 {
-  std::string fsid(4096, '\0');
-  int r = safe_read_file(path.c_str(), key.c_str(), fsid.data(), fsid.size());
-  if (r > 0) {
-    fsid.resize(r);
+  std::string fn = fmt::format("{}/{}", path, key);
+  return ceph::buffer::read_file(fn).then([](ceph::bufferptr&& bp) {
+    std::string value{bp.c_str(), bp.length()};
+    int r = value.size();
     // drop trailing newlines
-    boost::algorithm::trim_right_if(fsid,
+    boost::algorithm::trim_right_if(value,
 				    [](unsigned char c) {return isspace(c);});
-  } else {
-    fsid.clear();
-  }
-  return seastar::make_ready_future<int, std::string>(r, fsid);
+    return seastar::make_ready_future<int, std::string>(r, std::move(value));
+  }).handle_exception_type([](const std::system_error& e) {
+    return seastar::make_ready_future<int, std::string>(-e.code().value(),
+                                                        std::string{});
+  });
 }
 
 uuid_d CyanStore::get_fsid() const
@@ -1,7 +1,17 @@
 #include "ec_backend.h"
 
+#include <fmt/ostream.h>
+
+#include "crimson/common/log.h"
+#include "crimson/osd/exceptions.h"
 #include "crimson/osd/shard_services.h"
 
+namespace {
+  seastar::logger& logger() {
+    return crimson::get_logger(ceph_subsys_osd);
+  }
+}
+
 ECBackend::ECBackend(shard_id_t shard,
                      ECBackend::CollectionRef coll,
                      crimson::osd::ShardServices& shard_services,
@@ -9,7 +19,13 @@ ECBackend::ECBackend(shard_id_t shard,
                      uint64_t)
   : PGBackend{shard, coll, &shard_services.get_store()}
 {
-  // todo
+  // todo: erasure coding is not implemented yet, so until then fail every
+  // read and write with EOPNOTSUPP instead of returning empty data and
+  // acking writes which were never applied.  Writes are turned away by
+  // PG::do_osd_ops() already (see can_write()), _submit_transaction()
+  // failing is only a backstop.
+  logger().warn("ECBackend: erasure-coded pools are not supported yet, "
+                "ops on {} will fail", coll->get_cid());
 }
 
 ECBackend::ll_read_errorator::future<ceph::bufferlist>
@@ -19,7 +35,8 @@ ECBackend::_read(const hobject_t& hoid,
                  const uint32_t flags)
 {
   // todo
-  return seastar::make_ready_future<bufferlist>();
+  return seastar::make_exception_future<bufferlist>(
+    crimson::osd::operation_not_supported{});
 }
 
 seastar::future<crimson::osd::acked_peers_t>
@@ -31,5 +48,6 @@ ECBackend::_submit_transaction(std::set<pg_shard_t>&& pg_shards,
                                eversion_t ver)
 {
   // todo
-  return seastar::make_ready_future<crimson::osd::acked_peers_t>();
+  return seastar::make_exception_future<crimson::osd::acked_peers_t>(
+    crimson::osd::operation_not_supported{});
 }
@@ -38,6 +38,10 @@ struct invalid_argument : public error {
   invalid_argument() : error(std::errc::invalid_argument) {}
 };
 
+struct operation_not_supported : public error {
+  operation_not_supported() : error(std::errc::operation_not_supported) {}
+};
+
 // FIXME: error handling
 struct permission_denied : public error {
   permission_denied() : error(std::errc::operation_not_permitted) {}
@@ -513,6 +513,17 @@ seastar::future<Ref<MOSDOpReply>> PG::do_osd_ops(
   using osd_op_errorator = OpsExecuter::osd_op_errorator;
   const auto oid = m->get_snapid() == CEPH_SNAPDIR ? m->get_hobj().get_head()
                                                    : m->get_hobj();
+  if (m->has_flag(CEPH_OSD_FLAG_WRITE) && !backend->can_write()) {
+    // the ops would modify obc before the backend got to fail the txn,
+    // leaving the cached object state out of sync with the store
+    logger().debug(
+      "do_osd_ops: {} - object {} backend does not support writes",
+      *m,
+      obc->obs.oi.soid);
+    auto reply = make_message<MOSDOpReply>(
+      m.get(), -EOPNOTSUPP, get_osdmap_epoch(), 0, false);
+    return seastar::make_ready_future<Ref<MOSDOpReply>>(std::move(reply));
+  }
   auto ox =
     std::make_unique<OpsExecuter>(obc, *this/* as const& */, m);
   return crimson::do_for_each(
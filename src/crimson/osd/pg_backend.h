@@ -114,6 +114,11 @@ public:
     ceph::os::Transaction& trans);
 
   virtual void got_rep_op_reply(const MOSDRepOpReply&) {}
+  /// false if writes would fail; PG rejects them before running any op,
+  /// as ops update the cached ObjectState before submitting their txn
+  virtual bool can_write() const {
+    return true;
+  }
 
 protected:
   const shard_id_t shard;
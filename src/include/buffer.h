@@ -136,6 +136,9 @@ inline namespace v14_2_0 {
   int get_missed_crc();
   /// enable/disable tracking of cached crcs
   void track_cached_crc(bool b);
+  /// bytes of freed page-aligned buffers each thread may keep for reuse,
+  /// and again for those other threads free back to it (0 disables the pool)
+  void set_pool_thread_max_bytes(size_t bytes);
 
   /*
    * an abstract raw buffer.  with a reference count.
@@ -394,6 +397,11 @@ inline namespace v14_2_0 {
 
     ~ptr_node() = default;
 
+    // nodes are recycled through a small per-thread cache; a bufferlist
+    // needs one for every ptr it holds.
+    static void* operator new(size_t size);
+    static void operator delete(void* p);
+
     static std::unique_ptr<ptr_node, disposer>
     create(ceph::unique_leakable_ptr<raw> r) {
       return create_hypercombined(std::move(r));
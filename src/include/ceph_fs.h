@@ -156,6 +156,7 @@ extern const char *ceph_con_mode_name(int con_mode);
 #define CEPH_MSG_CLIENT_SNAP            0x312
 #define CEPH_MSG_CLIENT_CAPRELEASE      0x313
 #define CEPH_MSG_CLIENT_QUOTA           0x314
+#define CEPH_MSG_CLIENT_CAPS_BATCH      0x31f /* not 0x315: CLIENT_METRICS upstream */
 
 /* pool ops */
 #define CEPH_MSG_POOLOP_REPLY           48
@@ -52,15 +52,21 @@
 #define DEFINE_MSGR2_FEATURE(bit, incarnation, name)               \
 	const static uint64_t CEPH_MSGR2_FEATURE_##name = (1ULL << bit); \
 	const static uint64_t CEPH_MSGR2_FEATUREMASK_##name =            \
-			(1ULL << bit | CEPH_FEATURE_INCARNATION_##incarnation);
+			(1ULL << bit | CEPH_MSGR2_INCARNATION_##incarnation);
 
 #define HAVE_MSGR2_FEATURE(x, name) \
 	(((x) & (CEPH_MSGR2_FEATUREMASK_##name)) == (CEPH_MSGR2_FEATUREMASK_##name))
 
 
-#define CEPH_MSGR2_SUPPORTED_FEATURES (0ull)
+// Local extension, kept clear of the bits upstream assigns in sequence
+// (bit 0 is REVISION_1, bit 1 upstream's own, differently framed
+// COMPRESSION): a peer advertising either must never be sent our
+// compressed frames.
+DEFINE_MSGR2_FEATURE(63, 1, COMPRESSION) // on-wire message frame compression
 
-#define CEPH_MSGR2_REQUIRED_FEATURES (CEPH_MSGR2_SUPPORTED_FEATURES)
+#define CEPH_MSGR2_SUPPORTED_FEATURES (CEPH_MSGR2_FEATURE_COMPRESSION)
+
+#define CEPH_MSGR2_REQUIRED_FEATURES (0ull)
 
 
 /*
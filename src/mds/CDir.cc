@@ -1537,6 +1537,8 @@ void CDir::fetch(MDSContext *c, std::string_view want_dn, bool ignore_authpinnab
   // already fetching?
   if (state_test(CDir::STATE_FETCHING)) {
     dout(7) << "already fetching; waiting" << dendl;
+    if (c)
+      cache->promote_dir_fetch(this);
     return;
   }
 
@@ -1545,8 +1547,39 @@ void CDir::fetch(MDSContext *c, std::string_view want_dn, bool ignore_authpinnab
 
   if (cache->mds->logger) cache->mds->logger->inc(l_mds_dir_fetch);
 
-  std::set<dentry_key_t> empty;
-  _omap_fetch(NULL, empty);
+  cache->queue_dir_fetch(this);
+
+  // whoever wants the whole of this frag may well want its siblings too
+  // (readdir, rejoin, scrub); queue a few reads behind the real ones.
+  if (want_dn.empty() &&
+      g_conf().get_val<bool>("mds_dir_prefetch_siblings"))
+    prefetch_siblings();
+}
+
+void CDir::prefetch_siblings()
+{
+  // don't pull in all of a huge fragmented directory at once
+  uint64_t left = g_conf().get_val<uint64_t>("mds_dir_prefetch_siblings_max");
+  auto&& dfs = inode->get_dirfrags();
+  for (CDir *dir : dfs) {
+    if (!left)
+      break;
+    if (dir == this ||
+	!dir->is_auth() ||
+	dir->is_complete() ||
+	dir->state_test(CDir::STATE_FETCHING) ||
+	!dir->can_auth_pin())
+      continue;
+    dout(10) << __func__ << " " << *dir << dendl;
+    dir->auth_pin(dir);
+    dir->state_set(CDir::STATE_FETCHING);
+    if (cache->mds->logger) {
+      cache->mds->logger->inc(l_mds_dir_fetch);
+      cache->mds->logger->inc(l_mds_dir_prefetch);
+    }
+    cache->queue_dir_fetch(dir, true);
+    --left;
+  }
 }
 
 void CDir::fetch(MDSContext *c, const std::set<dentry_key_t>& keys)
@@ -1894,6 +1927,9 @@ void CDir::_omap_fetched(bufferlist& hdrbl, map<string, bufferlist>& omap,
   dout(10) << "_fetched header " << hdrbl.length() << " bytes "
 	   << omap.size() << " keys for " << *this << dendl;
 
+  if (complete)
+    cache->finish_dir_fetch(this);
+
   ceph_assert(r == 0 || r == -ENOENT || r == -ENODATA);
   ceph_assert(is_auth());
   ceph_assert(!is_frozen());
@@ -2349,7 +2349,7 @@ int Locker::issue_caps(CInode *in, Capability *only_cap)
 					   mds->get_osd_epoch_barrier());
 	in->encode_cap_message(m, cap);
 
-	mds->send_message_client_counted(m, cap->get_session());
+	mds->send_cap_message_client(m, cap->get_session());
       }
     }
 
@@ -2394,7 +2394,7 @@ int Locker::issue_caps(CInode *in, Capability *only_cap)
 					 mds->get_osd_epoch_barrier());
       in->encode_cap_message(m, cap);
 
-      mds->send_message_client_counted(m, cap->get_session());
+      mds->send_cap_message_client(m, cap->get_session());
     }
 
     if (only_cap)
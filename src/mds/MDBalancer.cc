@@ -847,6 +847,25 @@ void MDBalancer::try_rebalance(balance_state_t& state)
     return;
   }
 
+  auto now = clock::now();
+  auto import_hold = std::chrono::duration<double>(
+    g_conf().get_val<double>("mds_bal_import_hold"));
+  for (auto p = import_stamps.begin(); p != import_stamps.end(); ) {
+    if (now - p->second >= import_hold)
+      import_stamps.erase(p++);
+    else
+      ++p;
+  }
+  // samples older than a few balancer rounds say nothing about the trend
+  auto sample_max_age = std::chrono::seconds(
+    3 * g_conf().get_val<int64_t>("mds_bal_interval"));
+  for (auto p = load_samples.begin(); p != load_samples.end(); ) {
+    if (now - p->second.stamp >= sample_max_age)
+      load_samples.erase(p++);
+    else
+      ++p;
+  }
+
   // make a sorted list of my imports
   multimap<double, CDir*> import_pop_map;
   multimap<mds_rank_t, pair<CDir*, double> > import_from_map;
@@ -868,9 +887,16 @@ void MDBalancer::try_rebalance(balance_state_t& state)
 	from != mds->get_nodeid()) {
       dout(5) << " exporting idle (" << pop << ") import " << *dir
 	      << " back to mds." << from << dendl;
+      note_export(dir, from);
       mds->mdcache->migrator->export_dir_nicely(dir, from);
       continue;
     }
+    // the hold only keeps busy imports from bouncing on; idle ones still
+    // go back above
+    if (import_stamps.count(dir->dirfrag())) {
+      dout(15) << "  holding recent import " << *dir << dendl;
+      continue;
+    }
 
     dout(15) << "  map: i imported " << *dir << " from " << from << dendl;
     import_pop_map.insert(make_pair(pop, dir));
@@ -915,6 +941,7 @@ void MDBalancer::try_rebalance(balance_state_t& state)
 	if (pop <= amount-have) {
 	  dout(5) << "reexporting " << *dir << " pop " << pop
 		  << " back to mds." << target << dendl;
+	  note_export(dir, target);
 	  mds->mdcache->migrator->export_dir_nicely(dir, target);
 	  have += pop;
 	  import_from_map.erase(plast);
@@ -959,6 +986,7 @@ void MDBalancer::try_rebalance(balance_state_t& state)
 	dout(0) << "reexporting " << *dir << " pop " << pop
 		<< " to mds." << target << dendl;
 	have += pop;
+	note_export(dir, target);
 	mds->mdcache->migrator->export_dir_nicely(dir, target);
 	import_pop_map.erase(p++);
       } else {
@@ -998,6 +1026,7 @@ void MDBalancer::try_rebalance(balance_state_t& state)
       dout(5) << "   - exporting " << dir->pop_auth_subtree
 	      << " " << dir->pop_auth_subtree.meta_load()
 	      << " to mds." << target << " " << *dir << dendl;
+      note_export(dir, target);
       mds->mdcache->migrator->export_dir_nicely(dir, target);
     }
   }
@@ -1006,6 +1035,67 @@ void MDBalancer::try_rebalance(balance_state_t& state)
   mds->mdcache->show_subtrees();
 }
 
+void MDBalancer::note_export(CDir *dir, mds_rank_t target)
+{
+  export_record_t r;
+  r.stamp = ceph::real_clock::now();
+  r.dirfrag = dir->dirfrag();
+  r.target = target;
+  r.pop = dir->pop_auth_subtree.meta_load();
+  r.cost = export_cost(dir);
+  export_history.push_back(r);
+  if (export_history.size() > EXPORT_HISTORY_MAX)
+    export_history.pop_front();
+}
+
+double MDBalancer::subtree_export_cost(const fnode_t &fnode,
+				       double cost_per_inode)
+{
+  // The Migrator ships the whole nested subtree, not just this dirfrag, so
+  // size it from the recursive stats.  rstat may lag behind fragstat until
+  // it is propagated, so never count less than the direct entries.
+  int64_t inodes = std::max(fnode.rstat.rsize(), fnode.fragstat.size());
+  return cost_per_inode * inodes;
+}
+
+double MDBalancer::export_cost(CDir *dir) const
+{
+  return subtree_export_cost(*dir->get_projected_fnode(),
+			     g_conf().get_val<double>("mds_bal_export_cost"));
+}
+
+double MDBalancer::extrapolate_load(load_sample_t *sample, double pop,
+				    time now, double horizon)
+{
+  if (sample->stamp == clock::zero()) {
+    *sample = load_sample_t{now, pop};
+    return pop;
+  }
+  double dt = std::chrono::duration<double>(now - sample->stamp).count();
+  if (dt < 1.0) {
+    // seen earlier in this same round; too close for a slope
+    return pop;
+  }
+  double slope = (pop - sample->load) / dt;
+  *sample = load_sample_t{now, pop};
+  return std::max(0.0, pop + slope * horizon);
+}
+
+double MDBalancer::predict_load(CDir *dir, double pop, time now)
+{
+  double horizon = g_conf().get_val<double>("mds_bal_predict_horizon");
+  if (horizon <= 0)
+    return pop;
+
+  // linear trend of the decayed load since the last balancer round that
+  // looked at this dirfrag
+  double predicted = extrapolate_load(&load_samples[dir->dirfrag()], pop,
+				      now, horizon);
+  dout(20) << "   predicted load " << predicted << " (now " << pop
+	   << ") " << *dir << dendl;
+  return predicted;
+}
+
 void MDBalancer::find_exports(CDir *dir,
                               double amount,
                               std::vector<CDir*>* exports,
@@ -1032,7 +1122,8 @@ void MDBalancer::find_exports(CDir *dir,
   double minchunk = need * g_conf()->mds_bal_minchunk;
 
   std::vector<CDir*> bigger_rep, bigger_unrep;
-  multimap<double, CDir*> smaller;
+  // smaller candidates, ranked by predicted popularity net of migration cost
+  multimap<double, pair<double, CDir*>> smaller;
 
   double dir_pop = dir->pop_auth_subtree.meta_load();
   dout(7) << " find_exports in " << dir_pop << " " << *dir << " need " << need << " (" << needmin << " - " << needmax << ")" << dendl;
@@ -1082,8 +1173,17 @@ void MDBalancer::find_exports(CDir *dir,
 	  bigger_rep.push_back(subdir);
 	else
 	  bigger_unrep.push_back(subdir);
-      } else
-	smaller.insert(pair<double,CDir*>(pop, subdir));
+      } else {
+	// cost and trend only order the smaller candidates, and drop those
+	// not worth their migration cost
+	double cost = export_cost(subdir);
+	if (pop <= cost) {
+	  dout(15) << "   not worth moving, cost " << cost << " " << *subdir << dendl;
+	  continue;
+	}
+	double score = predict_load(subdir, pop, now) - cost;
+	smaller.insert(make_pair(score, make_pair(pop, subdir)));
+      }
     }
     if (dfls.size() == num_idle_frags)
       in->item_pop_lru.remove_myself();
@@ -1091,19 +1191,18 @@ void MDBalancer::find_exports(CDir *dir,
   dout(15) << "   sum " << subdir_sum << " / " << dir_pop << dendl;
 
   // grab some sufficiently big small items
-  multimap<double,CDir*>::reverse_iterator it;
-  for (it = smaller.rbegin();
+  for (auto it = smaller.rbegin();
        it != smaller.rend();
        ++it) {
 
-    if ((*it).first < midchunk)
-      break;  // try later
+    if (it->second.first < midchunk)
+      continue;  // try later
 
-    dout(7) << "   taking smaller " << *(*it).second << dendl;
+    dout(7) << "   taking smaller " << *it->second.second << dendl;
 
-    exports->push_back((*it).second);
-    already_exporting.insert((*it).second);
-    have += (*it).first;
+    exports->push_back(it->second.second);
+    already_exporting.insert(it->second.second);
+    have += it->second.first;
     if (have > needmin)
       return;
   }
@@ -1117,14 +1216,16 @@ void MDBalancer::find_exports(CDir *dir,
   }
 
   // ok fine, use smaller bits
-  for (;
+  for (auto it = smaller.rbegin();
        it != smaller.rend();
        ++it) {
-    dout(7) << "   taking (much) smaller " << it->first << " " << *(*it).second << dendl;
+    if (already_exporting.count(it->second.second))
+      continue;  // taken above
+    dout(7) << "   taking (much) smaller " << it->second.first << " " << *it->second.second << dendl;
 
-    exports->push_back((*it).second);
-    already_exporting.insert((*it).second);
-    have += (*it).first;
+    exports->push_back(it->second.second);
+    already_exporting.insert(it->second.second);
+    have += it->second.first;
     if (have > needmin)
       return;
   }
@@ -1300,6 +1401,9 @@ void MDBalancer::subtract_export(CDir *dir)
 
 void MDBalancer::add_import(CDir *dir)
 {
+  if (g_conf().get_val<double>("mds_bal_import_hold") > 0)
+    import_stamps[dir->dirfrag()] = clock::now();
+
   dirfrag_load_vec_t subload = dir->pop_auth_subtree;
 
   while (true) {
@@ -1437,6 +1541,18 @@ int MDBalancer::dump_loads(Formatter *f) const
   }
   f->close_section(); // mds_import_map
 
+  f->open_array_section("export_history");
+  for (const auto& r : export_history) {
+    f->open_object_section("export");
+    f->dump_stream("stamp") << r.stamp;
+    f->dump_stream("dirfrag") << r.dirfrag;
+    f->dump_int("target", r.target);
+    f->dump_float("pop", r.pop);
+    f->dump_float("cost", r.cost);
+    f->close_section();
+  }
+  f->close_section(); // export_history
+
   f->close_section(); // loads
   return 0;
 }
@@ -18,6 +18,8 @@
 #include "common/Clock.h"
 #include "common/Cond.h"
 
+#include <deque>
+
 #include "msg/Message.h"
 #include "messages/MHeartbeat.h"
 
@@ -53,6 +55,22 @@ public:
   void add_import(CDir *im);
   void adjust_pop_for_rename(CDir *pdir, CDir *dir, bool inc);
 
+  // load of an export candidate when the balancer last looked at it
+  struct load_sample_t {
+    time stamp = clock::zero();
+    double load = 0;
+  };
+  /**
+   * Extrapolate pop horizon seconds ahead on the linear trend since
+   * *sample, then make pop the new sample.  Returns pop unchanged without
+   * an earlier sample, or with one less than a second old.
+   */
+  static double extrapolate_load(load_sample_t *sample, double pop,
+				 time now, double horizon);
+  /// cost of migrating the subtree under a dirfrag with this fnode
+  static double subtree_export_cost(const fnode_t &fnode,
+				    double cost_per_inode);
+
   void hit_inode(CInode *in, int type, int who=-1);
   void hit_dir(CDir *dir, int type, int who=-1, double amount=1.0);
 
@@ -85,6 +103,12 @@ private:
 
   void handle_export_pins(void);
 
+  void note_export(CDir *dir, mds_rank_t target);
+  // migration cost of the whole subtree under dir (see mds_bal_export_cost)
+  double export_cost(CDir *dir) const;
+  // dir's load extrapolated from its last sample (see mds_bal_predict_horizon)
+  double predict_load(CDir *dir, double pop, time now);
+
   mds_load_t get_load();
   int localize_balancer();
   void send_heartbeat();
@@ -118,6 +142,7 @@ private:
   bool bal_fragment_dirs;
   int64_t bal_fragment_interval;
   static const unsigned int AUTH_TREES_THRESHOLD = 5;
+  static const unsigned int EXPORT_HISTORY_MAX = 100;
 
   MDSRank *mds;
   Messenger *messenger;
@@ -150,5 +175,21 @@ private:
   // per-epoch state
   double my_load = 0;
   double target_load = 0;
+
+  // when each recently imported subtree arrived (see mds_bal_import_hold)
+  std::map<dirfrag_t, time> import_stamps;
+
+  // export candidates' load when last seen, for predict_load()
+  std::map<dirfrag_t, load_sample_t> load_samples;
+
+  // recent balancer exports, for "dump loads"
+  struct export_record_t {
+    ceph::real_time stamp;
+    dirfrag_t dirfrag;
+    mds_rank_t target;
+    double pop;
+    double cost;
+  };
+  std::deque<export_record_t> export_history;
 };
 #endif
@@ -152,6 +152,7 @@ MDCache::MDCache(MDSRank *m, PurgeQueue &purge_queue_) :
   cache_reservation = g_conf().get_val<double>("mds_cache_reservation");
   cache_health_threshold = g_conf().get_val<double>("mds_health_cache_threshold");
   forward_all_requests_to_auth = g_conf().get_val<bool>("mds_forward_all_requests_to_auth");
+  standby_replay_warm_cache = g_conf().get_val<bool>("mds_standby_replay_warm_cache");
 
   lru.lru_set_midpoint(g_conf().get_val<double>("mds_cache_mid"));
 
@@ -227,6 +228,8 @@ void MDCache::handle_conf_change(const std::set<std::string>& changed, const MDS
   if (changed.count("mds_forward_all_requests_to_auth")){
     forward_all_requests_to_auth = g_conf().get_val<bool>("mds_forward_all_requests_to_auth");
   }
+  if (changed.count("mds_standby_replay_warm_cache"))
+    standby_replay_warm_cache = g_conf().get_val<bool>("mds_standby_replay_warm_cache");
 
   migrator->handle_conf_change(changed, mdsmap);
   mds->balancer->handle_conf_change(changed, mdsmap);
@@ -6621,7 +6624,8 @@ void MDCache::purge_inodes(const interval_set<inodeno_t>& inos, LogSegment *ls)
 
 std::pair<bool, uint64_t> MDCache::trim_lru(uint64_t count, expiremap& expiremap)
 {
-  bool is_standby_replay = mds->is_standby_replay();
+  // a warm standby-replay trims like an active MDS, to the memory limit only
+  bool is_standby_replay = mds->is_standby_replay() && !standby_replay_warm_cache;
   std::vector<CDentry *> unexpirables;
   uint64_t trimmed = 0;
 
@@ -7308,8 +7312,13 @@ void MDCache::try_trim_non_auth_subtree(CDir *dir)
 
 void MDCache::standby_trim_segment(LogSegment *ls)
 {
-  auto try_trim_inode = [this](CInode *in) {
-    if (in->get_num_ref() == 0 &&
+  // with a warm cache, items from expired segments are just marked clean
+  // and left where they are in the lru
+  const bool keep = standby_replay_warm_cache;
+
+  auto try_trim_inode = [this, keep](CInode *in) {
+    if (!keep &&
+	in->get_num_ref() == 0 &&
 	!in->item_open_file.is_on_list() &&
 	in->parent != NULL &&
 	in->parent->get_num_ref() == 0){
@@ -7317,8 +7326,8 @@ void MDCache::standby_trim_segment(LogSegment *ls)
     }
   };
 
-  auto try_trim_dentry = [this](CDentry *dn) {
-    if (dn->get_num_ref() > 0)
+  auto try_trim_dentry = [this, keep](CDentry *dn) {
+    if (keep || dn->get_num_ref() > 0)
       return;
     auto in = dn->get_linkage()->inode;
     if(in && in->item_open_file.is_on_list())
@@ -9990,6 +9999,88 @@ void MDCache::scan_stray_dir(dirfrag_t next)
   }
 }
 
+void MDCache::queue_dir_fetch(CDir *dir, bool prefetch)
+{
+  ceph_assert(dir->state_test(CDir::STATE_FETCHING));
+  if (prefetch) {
+    dir_prefetches.insert(dir);
+    if (!dir_fetch_queue.empty() || !can_issue_dir_prefetch()) {
+      dout(10) << __func__ << " queueing prefetch " << *dir << dendl;
+      dir_prefetch_queue.push_back(dir);
+      return;
+    }
+    ++num_dir_prefetching;
+  } else {
+    uint64_t max = g_conf().get_val<uint64_t>("mds_dir_fetch_max_inflight");
+    if (max && num_dir_fetching >= max) {
+      dout(10) << __func__ << " " << num_dir_fetching << " fetches in flight, queueing "
+	       << *dir << dendl;
+      dir_fetch_queue.push_back(dir);
+      return;
+    }
+  }
+  issue_dir_fetch(dir);
+}
+
+void MDCache::promote_dir_fetch(CDir *dir)
+{
+  if (!dir_prefetches.erase(dir))
+    return;
+  auto p = std::find(dir_prefetch_queue.begin(), dir_prefetch_queue.end(), dir);
+  if (p == dir_prefetch_queue.end()) {
+    // already in flight, now on behalf of a waiter
+    ceph_assert(num_dir_prefetching > 0);
+    --num_dir_prefetching;
+    return;
+  }
+  dout(10) << __func__ << " " << *dir << dendl;
+  dir_prefetch_queue.erase(p);
+  queue_dir_fetch(dir);
+}
+
+bool MDCache::can_issue_dir_prefetch() const
+{
+  uint64_t max = g_conf().get_val<uint64_t>("mds_dir_fetch_max_inflight");
+  return !max ||
+    (num_dir_fetching < max &&
+     num_dir_prefetching < std::max<uint64_t>(1, max / 4));
+}
+
+void MDCache::issue_dir_fetch(CDir *dir)
+{
+  ++num_dir_fetching;
+  dir->_omap_fetch(NULL, {});
+}
+
+void MDCache::finish_dir_fetch(CDir *dir)
+{
+  ceph_assert(num_dir_fetching > 0);
+  --num_dir_fetching;
+  if (dir_prefetches.erase(dir)) {
+    ceph_assert(num_dir_prefetching > 0);
+    --num_dir_prefetching;
+  }
+
+  // fetches with waiters first
+  uint64_t max = g_conf().get_val<uint64_t>("mds_dir_fetch_max_inflight");
+  while (!dir_fetch_queue.empty() &&
+	 (!max || num_dir_fetching < max)) {
+    CDir *next = dir_fetch_queue.front();
+    dir_fetch_queue.pop_front();
+    dout(10) << __func__ << " starting queued fetch " << *next << dendl;
+    issue_dir_fetch(next);
+  }
+  while (dir_fetch_queue.empty() &&
+	 !dir_prefetch_queue.empty() &&
+	 can_issue_dir_prefetch()) {
+    CDir *next = dir_prefetch_queue.front();
+    dir_prefetch_queue.pop_front();
+    dout(10) << __func__ << " starting queued prefetch " << *next << dendl;
+    ++num_dir_prefetching;
+    issue_dir_fetch(next);
+  }
+}
+
 void MDCache::fetch_backtrace(inodeno_t ino, int64_t pool, bufferlist& bl, Context *fin)
 {
   object_t oid = CInode::get_object_name(ino, frag_t(), "");
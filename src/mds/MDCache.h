@@ -15,6 +15,7 @@
 #define CEPH_MDCACHE_H
 
 #include <atomic>
+#include <deque>
 #include <string_view>
 #include <thread>
 
@@ -841,6 +842,20 @@ class MDCache {
   void handle_snap_update(const cref_t<MMDSSnapUpdate> &m);
   void notify_global_snaprealm_update(int snap_op);
 
+  // -- dirfrag fetch --
+  /**
+   * Issue the omap read for a whole-dirfrag fetch, or park it until one of
+   * the in-flight fetches completes if mds_dir_fetch_max_inflight are
+   * already outstanding.  The dirfrag must be auth pinned and FETCHING.
+   *
+   * Prefetches (nobody waiting on them) queue behind all parked demand
+   * fetches and take at most a quarter of the in-flight slots.
+   */
+  void queue_dir_fetch(CDir *dir, bool prefetch=false);
+  /// someone now waits on a dirfrag that was being prefetched
+  void promote_dir_fetch(CDir *dir);
+  void finish_dir_fetch(CDir *dir);
+
   // -- stray --
   void fetch_backtrace(inodeno_t ino, int64_t pool, bufferlist& bl, Context *fin);
   uint64_t get_num_strays() const { return stray_manager.get_num_strays(); }
@@ -1285,11 +1300,22 @@ class MDCache {
   double cache_reservation;
   double cache_health_threshold;
   bool forward_all_requests_to_auth;
+  bool standby_replay_warm_cache;
   std::array<CInode *, NUM_STRAY> strays{}; // my stray dir
 
   // File size recovery
   RecoveryQueue recovery_queue;
 
+  // whole-dirfrag fetches: in flight, and waiting for a slot
+  bool can_issue_dir_prefetch() const;
+  void issue_dir_fetch(CDir *dir);
+  unsigned num_dir_fetching = 0;
+  std::deque<CDir*> dir_fetch_queue;
+  // prefetches, queued or in flight, of which num_dir_prefetching in flight
+  std::set<CDir*> dir_prefetches;
+  unsigned num_dir_prefetching = 0;
+  std::deque<CDir*> dir_prefetch_queue;
+
   // shutdown
   set<inodeno_t> shutdown_exporting_strays;
   pair<dirfrag_t, string> shutdown_export_next;
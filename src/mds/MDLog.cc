@@ -67,6 +67,7 @@ void MDLog::create_logger()
   plb.add_u64_counter(l_mdl_replayed, "replayed", "Events replayed",
 		      "repl", PerfCountersBuilder::PRIO_INTERESTING);
   plb.add_time_avg(l_mdl_jlat, "jlat", "Journaler flush latency");
+  plb.add_u64_counter(l_mdl_flush, "flush", "Journal flushes requested by the submit thread");
   plb.add_u64_counter(l_mdl_evex, "evex", "Total expired events");
   plb.add_u64_counter(l_mdl_evtrm, "evtrm", "Trimmed events");
   plb.add_u64_counter(l_mdl_segadd, "segadd", "Segments added");
@@ -374,67 +375,82 @@ void MDLog::_submit_thread()
     }
 
     int64_t features = mdsmap_up_features;
-    PendingEvent data = it->second.front();
-    it->second.pop_front();
+    // group commit: take everything queued for this segment (up to
+    // mds_log_batch_events), append it in one go and flush at most once
+    list<PendingEvent> batch;
+    {
+      auto end = it->second.begin();
+      uint64_t max_batch = g_conf().get_val<uint64_t>("mds_log_batch_events");
+      for (uint64_t n = 0; n < max_batch && end != it->second.end(); ++n)
+	++end;
+      batch.splice(batch.end(), it->second, it->second.begin(), end);
+    }
 
     locker.unlock();
 
-    if (data.le) {
-      LogEvent *le = data.le;
-      LogSegment *ls = le->_segment;
-      // encode it, with event type
-      bufferlist bl;
-      le->encode_with_header(bl, features);
-
-      uint64_t write_pos = journaler->get_write_pos();
-
-      le->set_start_off(write_pos);
-      if (le->get_type() == EVENT_SUBTREEMAP)
-	ls->offset = write_pos;
-
-      dout(5) << "_submit_thread " << write_pos << "~" << bl.length()
-	      << " : " << *le << dendl;
-
-      // journal it.
-      const uint64_t new_write_pos = journaler->append_entry(bl);  // bl is destroyed.
-      ls->end = new_write_pos;
-
-      MDSLogContextBase *fin;
-      if (data.fin) {
-	fin = dynamic_cast<MDSLogContextBase*>(data.fin);
-	ceph_assert(fin);
-	fin->set_write_pos(new_write_pos);
+    bool flush = false;
+    uint64_t appended = 0;
+    for (auto& data : batch) {
+      if (data.le) {
+	LogEvent *le = data.le;
+	LogSegment *ls = le->_segment;
+	// encode it, with event type
+	bufferlist bl;
+	le->encode_with_header(bl, features);
+
+	uint64_t write_pos = journaler->get_write_pos();
+
+	le->set_start_off(write_pos);
+	if (le->get_type() == EVENT_SUBTREEMAP)
+	  ls->offset = write_pos;
+
+	dout(5) << "_submit_thread " << write_pos << "~" << bl.length()
+		<< " : " << *le << dendl;
+
+	// journal it.
+	const uint64_t new_write_pos = journaler->append_entry(bl);  // bl is destroyed.
+	ls->end = new_write_pos;
+
+	MDSLogContextBase *fin;
+	if (data.fin) {
+	  fin = dynamic_cast<MDSLogContextBase*>(data.fin);
+	  ceph_assert(fin);
+	  fin->set_write_pos(new_write_pos);
+	} else {
+	  fin = new C_MDL_Flushed(this, new_write_pos);
+	}
+
+	journaler->wait_for_flush(fin);
+
+	if (logger)
+	  logger->set(l_mdl_wrpos, ls->end);
+
+	delete le;
+	++appended;
       } else {
-	fin = new C_MDL_Flushed(this, new_write_pos);
+	if (data.fin) {
+	  MDSContext* fin =
+		  dynamic_cast<MDSContext*>(data.fin);
+	  ceph_assert(fin);
+	  C_MDL_Flushed *fin2 = new C_MDL_Flushed(this, fin);
+	  fin2->set_write_pos(journaler->get_write_pos());
+	  journaler->wait_for_flush(fin2);
+	}
       }
+      flush |= data.flush;
+    }
 
-      journaler->wait_for_flush(fin);
-
-      if (data.flush)
-	journaler->flush();
-
+    if (flush) {
+      journaler->flush();
       if (logger)
-	logger->set(l_mdl_wrpos, ls->end);
-
-      delete le;
-    } else {
-      if (data.fin) {
-	MDSContext* fin =
-		dynamic_cast<MDSContext*>(data.fin);
-	ceph_assert(fin);
-	C_MDL_Flushed *fin2 = new C_MDL_Flushed(this, fin);
-	fin2->set_write_pos(journaler->get_write_pos());
-	journaler->wait_for_flush(fin2);
-      }
-      if (data.flush)
-	journaler->flush();
+	logger->inc(l_mdl_flush);
     }
 
     locker.lock();
-    if (data.flush)
+    if (flush)
       unflushed = 0;
-    else if (data.le)
-      unflushed++;
+    else
+      unflushed += appended;
   }
 }
 
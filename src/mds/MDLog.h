@@ -33,6 +33,7 @@ enum {
   l_mdl_rdpos,
   l_mdl_jlat,
   l_mdl_replayed,
+  l_mdl_flush,
   l_mdl_last,
 };
 
@@ -739,6 +739,9 @@ void MDSRankDispatcher::tick()
     logger->set(l_mds_subtrees, mdcache->num_subtrees());
     mdcache->log_stat();
   }
+  if (is_active() || is_stopping()) {
+    purge_queue.update_eta();
+  }
 
   if (is_reconnect())
     server->reconnect_tick();
@@ -1413,6 +1416,8 @@ void MDSRank::send_message_client_counted(const ref_t<Message>& m, const Connect
 
 void MDSRank::send_message_client_counted(const ref_t<Message>& m, Session* session)
 {
+  if (!cap_batches.empty())
+    flush_cap_batch(session);
   version_t seq = session->inc_push_seq();
   dout(10) << "send_message_client_counted " << session->info.inst.name << " seq "
 	   << seq << " " << *m << dendl;
@@ -1425,6 +1430,8 @@ void MDSRank::send_message_client_counted(const ref_t<Message>& m, Session* sess
 
 void MDSRank::send_message_client(const ref_t<Message>& m, Session* session)
 {
+  if (!cap_batches.empty())
+    flush_cap_batch(session);
   dout(10) << "send_message_client " << session->info.inst << " " << *m << dendl;
   if (session->get_connection()) {
     session->get_connection()->send_message2(m);
@@ -1433,6 +1440,72 @@ void MDSRank::send_message_client(const ref_t<Message>& m, Session* session)
   }
 }
 
+void MDSRank::send_cap_message_client(const ref_t<MClientCaps>& m, Session* session)
+{
+  double interval = g_conf().get_val<double>("mds_cap_batch_interval");
+  if (interval <= 0 ||
+      !session->info.has_feature(CEPHFS_FEATURE_CAPS_BATCH)) {
+    send_message_client_counted(m, session);
+    return;
+  }
+
+  version_t seq = session->inc_push_seq();
+  dout(10) << __func__ << " " << session->info.inst.name << " seq "
+	   << seq << " " << *m << dendl;
+  auto& batch = cap_batches[session->get_client()];
+  if (!batch.second || batch.first != session->info.inst) {
+    // nothing pending, or left over from a session that has since gone
+    batch.first = session->info.inst;
+    batch.second = make_message<MClientCapsBatch>();
+  }
+  batch.second->caps.push_back(m);
+
+  if (batch.second->caps.size() >= CAP_BATCH_MAX) {
+    flush_cap_batch(session);
+  } else if (!cap_batch_timer) {
+    cap_batch_timer = new LambdaContext([this](int) {
+	cap_batch_timer = nullptr;
+	flush_cap_batches();
+      });
+    timer.add_event_after(interval, cap_batch_timer);
+  }
+}
+
+void MDSRank::flush_cap_batch(Session *session)
+{
+  auto p = cap_batches.find(session->get_client());
+  if (p == cap_batches.end())
+    return;
+  auto batch = std::move(p->second);
+  cap_batches.erase(p);
+  if (batch.first != session->info.inst)
+    return;
+
+  ref_t<Message> m;
+  if (batch.second->caps.size() == 1)
+    m = batch.second->caps.front();
+  else
+    m = batch.second;
+  dout(10) << __func__ << " " << session->info.inst.name << " " << *m << dendl;
+  if (session->get_connection()) {
+    session->get_connection()->send_message2(m);
+  } else {
+    session->preopen_out_queue.push_back(m);
+  }
+}
+
+void MDSRank::flush_cap_batches()
+{
+  while (!cap_batches.empty()) {
+    client_t client = cap_batches.begin()->first;
+    Session *session = sessionmap.get_session(entity_name_t::CLIENT(client.v));
+    if (session)
+      flush_cap_batch(session);
+    else
+      cap_batches.erase(client);
+  }
+}
+
 /**
  * This is used whenever a RADOS operation has been cancelled
  * or a RADOS client has been blacklisted, to cause the MDS and
@@ -3169,6 +3242,8 @@ void MDSRank::create_logger()
     mds_plb.add_u64(l_mds_root_rbytes, "root_rbytes", "root inode rbytes");
     mds_plb.add_u64(l_mds_root_rsnaps, "root_rsnaps", "root inode rsnaps");
     mds_plb.add_u64_counter(l_mds_dir_fetch, "dir_fetch", "Directory fetch");
+    mds_plb.add_u64_counter(l_mds_dir_prefetch, "dir_prefetch",
+                            "Sibling directory fragment prefetch");
     mds_plb.add_u64_counter(l_mds_dir_commit, "dir_commit", "Directory commit");
     mds_plb.add_u64_counter(l_mds_dir_split, "dir_split", "Directory split");
     mds_plb.add_u64_counter(l_mds_dir_merge, "dir_merge", "Directory merge");
@@ -3531,6 +3606,7 @@ const char** MDSRankDispatcher::get_tracked_conf_keys() const
     "mds_request_load_average_decay_rate",
     "mds_session_cache_liveness_decay_rate",
     "mds_replay_unsafe_with_closed_session",
+    "mds_standby_replay_warm_cache",
     NULL
   };
   return KEYS;
@@ -22,6 +22,7 @@
 #include "common/Timer.h"
 #include "common/TrackedOp.h"
 
+#include "messages/MClientCapsBatch.h"
 #include "messages/MClientRequest.h"
 #include "messages/MCommand.h"
 #include "messages/MMDSMap.h"
@@ -48,6 +49,7 @@ enum {
   l_mds_reply_latency,
   l_mds_forward,
   l_mds_dir_fetch,
+  l_mds_dir_prefetch,
   l_mds_dir_commit,
   l_mds_dir_split,
   l_mds_dir_merge,
@@ -267,6 +269,15 @@ class MDSRank {
     void send_message_client_counted(const ref_t<Message>& m, Session* session);
     void send_message_client_counted(const ref_t<Message>& m, const ConnectionRef& connection);
     void send_message_client(const ref_t<Message>& m, Session* session);
+    /**
+     * Send a counted cap message, coalescing it with others for the same
+     * session into one MClientCapsBatch if the client supports that and
+     * mds_cap_batch_interval is set.  Any other message sent to the session
+     * flushes the pending batch first, so ordering is unchanged.
+     */
+    void send_cap_message_client(const ref_t<MClientCaps>& m, Session* session);
+    void flush_cap_batch(Session *session);
+    void flush_cap_batches();
     void send_message(const ref_t<Message>& m, const ConnectionRef& c);
 
     void wait_for_active_peer(mds_rank_t who, MDSContext *c) { 
@@ -550,6 +561,11 @@ class MDSRank {
 
     epoch_t osd_epoch_barrier = 0;
 
+    // cap messages waiting to go out as one MClientCapsBatch, by client
+    static constexpr unsigned CAP_BATCH_MAX = 256;
+    std::map<client_t, std::pair<entity_inst_t, ref_t<MClientCapsBatch>>> cap_batches;
+    Context *cap_batch_timer = nullptr;
+
     // Const reference to the beacon so that we can behave differently
     // when it's laggy.
     Beacon &beacon;
@@ -118,6 +118,9 @@ void PurgeQueue::create_logger()
   pcb.add_u64(l_pq_executing, "pq_executing", "Purge queue tasks in flight");
   pcb.add_u64(l_pq_executing_high_water, "pq_executing_high_water", "Maximum number of executing file purges");
   pcb.add_u64(l_pq_item_in_journal, "pq_item_in_journal", "Purge item left in journal");
+  pcb.add_time_avg(l_pq_item_latency, "pq_item_latency", "Purge item execution latency");
+  pcb.add_u64(l_pq_op_limit, "pq_op_limit", "Purge queue ops limit in effect");
+  pcb.add_u64(l_pq_eta, "pq_eta", "Estimated seconds to purge items left in journal");
 
   logger.reset(pcb.create_perf_counters());
   g_ceph_context->get_perfcounters_collection()->add(logger.get());
@@ -367,7 +370,7 @@ bool PurgeQueue::_can_consume()
     return false;
   }
 
-  dout(20) << ops_in_flight << "/" << max_purge_ops << " ops, "
+  dout(20) << ops_in_flight << "/" << _get_op_limit() << " ops, "
            << in_flight.size() << "/" << g_conf()->mds_max_purge_files
            << " files" << dendl;
 
@@ -379,9 +382,10 @@ bool PurgeQueue::_can_consume()
     return true;
   }
 
-  if (ops_in_flight >= max_purge_ops) {
+  const uint64_t op_limit = _get_op_limit();
+  if (ops_in_flight >= op_limit) {
     dout(20) << "Throttling on op limit " << ops_in_flight << "/"
-             << max_purge_ops << dendl;
+             << op_limit << dendl;
     return false;
   }
 
@@ -562,8 +566,15 @@ void PurgeQueue::_execute_item(
   ceph_assert(gather.has_subs());
 
   gather.set_finisher(new C_OnFinisher(
-                      new LambdaContext([this, expire_to](int r){
+                      new LambdaContext([this, expire_to, ops,
+                                         start=ceph::mono_clock::now()](int r){
     std::lock_guard l(lock);
+    auto latency = ceph::mono_clock::now() - start;
+    logger->tinc(l_pq_item_latency, latency);
+    // big items take longer because they issue more ops, not because the
+    // OSDs are slow; adapt on the latency per op
+    _adapt_op_limit(std::chrono::duration<double>(latency).count() /
+                    std::max(ops, 1u));
     _execute_item_complete(expire_to);
 
     _consume();
@@ -631,6 +642,16 @@ void PurgeQueue::_execute_item_complete(
   logger->set(l_pq_executing_high_water, files_high_water);
   dout(10) << "in_flight.size() now " << in_flight.size() << dendl;
 
+  uint64_t item_num = _get_item_num();
+  logger->set(l_pq_item_in_journal, item_num);
+  logger->inc(l_pq_executed);
+
+  executed_rate.hit();
+  _update_eta(item_num);
+}
+
+uint64_t PurgeQueue::_get_item_num()
+{
   uint64_t write_pos = journaler.get_write_pos(); 
   uint64_t read_pos = journaler.get_read_pos(); 
   uint64_t expire_pos = journaler.get_expire_pos(); 
@@ -640,9 +661,59 @@ void PurgeQueue::_execute_item_complete(
     << " (purge_item_journal_size/write_pos/read_pos/expire_pos) now at " 
     << "(" << purge_item_journal_size << "/" << write_pos << "/" << read_pos 
     << "/" << expire_pos << ")" << dendl;
+  return item_num;
+}
 
-  logger->set(l_pq_item_in_journal, item_num);
-  logger->inc(l_pq_executed);
+void PurgeQueue::_update_eta(uint64_t item_num)
+{
+  // items/sec over the recent past; a DecayCounter hit at rate r settles
+  // at r * halflife / ln(2).  With no completions the rate keeps decaying,
+  // so a stalled queue's ETA grows instead of freezing.
+  double rate = executed_rate.get() * M_LN2 / 60.0;
+  logger->set(l_pq_eta, item_num && rate > 0 ? uint64_t(item_num / rate) : 0);
+}
+
+void PurgeQueue::update_eta()
+{
+  std::lock_guard l(lock);
+  if (!logger || readonly) {
+    return;
+  }
+  _update_eta(_get_item_num());
+}
+
+uint64_t PurgeQueue::_get_op_limit() const
+{
+  if (draining || adaptive_purge_ops <= 0)
+    return max_purge_ops;
+  return adaptive_purge_ops;
+}
+
+void PurgeQueue::_adapt_op_limit(double latency)
+{
+  double target = cct->_conf.get_val<double>("mds_purge_target_latency");
+  if (target <= 0 || draining) {
+    adaptive_purge_ops = 0;
+    return;
+  }
+  if (adaptive_purge_ops <= 0)
+    adaptive_purge_ops = max_purge_ops;
+
+  // Grow by one op for every item that completes within the target while
+  // the OSDs keep up; halve, at most once per target interval, when they
+  // do not.  Never go above the administrator's hard limit.
+  double ceiling = cct->_conf->mds_max_purge_ops ?
+    cct->_conf->mds_max_purge_ops : 0xffff;
+  auto now = ceph::mono_clock::now();
+  if (latency <= target) {
+    adaptive_purge_ops = std::min(ceiling, adaptive_purge_ops + 1);
+  } else if (now - last_op_limit_cut > ceph::make_timespan(target)) {
+    last_op_limit_cut = now;
+    adaptive_purge_ops = std::max(1.0, adaptive_purge_ops / 2);
+    dout(10) << "item latency " << latency << "s over target " << target
+             << "s, op limit now " << uint64_t(adaptive_purge_ops) << dendl;
+  }
+  logger->set(l_pq_op_limit, _get_op_limit());
 }
 
 void PurgeQueue::update_op_limit(const MDSMap &mds_map)
@@ -679,6 +750,10 @@ void PurgeQueue::update_op_limit(const MDSMap &mds_map)
   if (cct->_conf->mds_max_purge_ops) {
     max_purge_ops = std::min(max_purge_ops, cct->_conf->mds_max_purge_ops);
   }
+  if (logger) {
+    logger->set(l_pq_op_limit, _get_op_limit());
+    _update_eta(_get_item_num());
+  }
 }
 
 void PurgeQueue::handle_conf_change(const std::set<std::string>& changed, const MDSMap& mds_map)
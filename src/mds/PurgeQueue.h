@@ -16,6 +16,7 @@
 #define PURGE_QUEUE_H_
 
 #include "include/compact_set.h"
+#include "common/DecayCounter.h"
 #include "mds/MDSMap.h"
 #include "osdc/Journaler.h"
 
@@ -90,6 +91,9 @@ enum {
   l_pq_executing_high_water,
   l_pq_executed,
   l_pq_item_in_journal,
+  l_pq_item_latency,
+  l_pq_op_limit,
+  l_pq_eta,
   l_pq_last
 };
 
@@ -151,6 +155,8 @@ public:
     size_t *in_flight_count);
 
   void update_op_limit(const MDSMap &mds_map);
+  // refresh pq_eta even while nothing completes; called from MDS tick
+  void update_eta();
 
   void handle_conf_change(const std::set<std::string>& changed, const MDSMap& mds_map);
 
@@ -170,6 +176,12 @@ private:
 
   void _execute_item(const PurgeItem &item, uint64_t expire_to);
   void _execute_item_complete(uint64_t expire_to);
+  uint64_t _get_item_num();
+  void _update_eta(uint64_t item_num);
+
+  // current ops limit, adapted to item latency if mds_purge_target_latency
+  uint64_t _get_op_limit() const;
+  void _adapt_op_limit(double latency);
 
   void _go_readonly(int r);
 
@@ -203,6 +215,13 @@ private:
   // Dynamic op limit per MDS based on PG count
   uint64_t max_purge_ops = 0;
 
+  // Latency-driven op limit (AIMD), starting from max_purge_ops
+  double adaptive_purge_ops = 0;
+  ceph::mono_time last_op_limit_cut;
+
+  // Recent item completion rate, for the ETA perf counter
+  DecayCounter executed_rate{DecayRate(60.0)};
+
   // How many bytes were remaining when drain() was first called,
   // used for indicating progress.
   uint64_t drain_initial = 0;
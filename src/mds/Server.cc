@@ -153,6 +153,11 @@ void Server::create_logger()
                       PerfCountersBuilder::PRIO_INTERESTING);
   plb.add_u64_counter(l_mdss_cap_revoke_eviction, "cap_revoke_eviction",
                       "Cap Revoke Client Eviction", "cre", PerfCountersBuilder::PRIO_INTERESTING);
+  plb.add_u64_counter(l_mdss_readdir_entries, "readdir_entries",
+                      "Dentries returned by readdir");
+  plb.add_u64_counter(l_mdss_readdir_bytes, "readdir_bytes",
+                      "Bytes of dentry and inode state encoded by readdir",
+                      NULL, 0, unit_t(UNIT_BYTES));
 
   // fop latencies are useful
   plb.set_prio_default(PerfCountersBuilder::PRIO_USEFUL);
@@ -4675,6 +4680,10 @@ void Server::handle_client_readdir(MDRequestRef& mdr)
 	   << " end=" << (int)end
 	   << dendl;
   mdr->reply_extra_bl = dirbl;
+  if (logger) {
+    logger->inc(l_mdss_readdir_entries, numfiles);
+    logger->inc(l_mdss_readdir_bytes, dirbl.length());
+  }
 
   // bump popularity.  NOTE: this doesn't quite capture it.
   mds->balancer->hit_dir(dir, META_POP_IRD, -1, numfiles);
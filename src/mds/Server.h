@@ -76,6 +76,8 @@ enum {
   l_mdss_req_symlink_latency,
   l_mdss_req_unlink_latency,
   l_mdss_cap_revoke_eviction,
+  l_mdss_readdir_entries,
+  l_mdss_readdir_bytes,
   l_mdss_last,
 };
 
@@ -34,6 +34,10 @@
 #define CEPHFS_FEATURE_NAUTILUS         12
 #define CEPHFS_FEATURE_DELEG_INO        13
 #define CEPHFS_FEATURE_OCTOPUS          13
+// Local extension: taken from the top of the first bitset word, well clear
+// of the bits upstream assigns in sequence (14 is METRIC_COLLECT, which
+// kernel clients advertise).
+#define CEPHFS_FEATURE_CAPS_BATCH       63
 
 #define CEPHFS_FEATURES_ALL {		\
   0, 1, 2, 3, 4,			\
@@ -48,6 +52,7 @@
   CEPHFS_FEATURE_NAUTILUS,              \
   CEPHFS_FEATURE_DELEG_INO,             \
   CEPHFS_FEATURE_OCTOPUS,               \
+  CEPHFS_FEATURE_CAPS_BATCH,            \
 }
 
 #define CEPHFS_FEATURES_MDS_SUPPORTED CEPHFS_FEATURES_ALL
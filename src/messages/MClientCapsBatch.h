@@ -0,0 +1,95 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+/*
+ * Ceph - scalable distributed file system
+ *
+ * This is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License version 2.1, as published by the Free Software
+ * Foundation.  See file COPYING.
+ *
+ */
+
+#ifndef CEPH_MCLIENTCAPSBATCH_H
+#define CEPH_MCLIENTCAPSBATCH_H
+
+#include "msg/Message.h"
+#include "messages/MClientCaps.h"
+
+/**
+ * Several MClientCaps for one session, sent as a single message to clients
+ * advertising CEPHFS_FEATURE_CAPS_BATCH.  Each cap message keeps its own
+ * version, tid, front and middle, and is handled by the client exactly as
+ * if it had arrived on its own, in order.
+ */
+class MClientCapsBatch : public SafeMessage {
+private:
+  static constexpr int HEAD_VERSION = 1;
+  static constexpr int COMPAT_VERSION = 1;
+
+public:
+  std::vector<ref_t<MClientCaps>> caps;
+
+protected:
+  MClientCapsBatch()
+    : SafeMessage{CEPH_MSG_CLIENT_CAPS_BATCH, HEAD_VERSION, COMPAT_VERSION} {}
+  ~MClientCapsBatch() override {}
+
+public:
+  std::string_view get_type_name() const override { return "client_caps_batch"; }
+  void print(ostream& out) const override {
+    out << "client_caps_batch(" << caps.size() << ")";
+  }
+
+  void encode_payload(uint64_t features) override {
+    using ceph::encode;
+    __u32 n = caps.size();
+    encode(n, payload);
+    for (auto& m : caps) {
+      if (m->get_payload().length() == 0)
+	m->encode_payload(features);
+      encode(m->get_header().version, payload);
+      encode(m->get_tid(), payload);
+      encode(m->get_payload(), payload);
+      encode(m->get_middle(), payload);
+    }
+  }
+  void decode_payload() override {
+    using ceph::decode;
+    auto p = payload.cbegin();
+    __u32 n;
+    decode(n, p);
+    caps.reserve(n);
+    for (__u32 i = 0; i < n; i++) {
+      __u16 version;
+      ceph_tid_t tid;
+      bufferlist front, middle;
+      decode(version, p);
+      decode(tid, p);
+      decode(front, p);
+      decode(middle, p);
+
+      // inherit source etc. from the batch so the client can match the
+      // cap message to its session
+      ceph_msg_header h = get_header();
+      h.type = CEPH_MSG_CLIENT_CAPS;
+      h.version = version;
+      h.tid = tid;
+      h.front_len = front.length();
+      h.middle_len = middle.length();
+      h.data_len = 0;
+
+      auto m = ceph::make_message<MClientCaps>();
+      m->set_header(h);
+      m->set_payload(front);
+      m->set_middle(middle);
+      m->decode_payload();
+      caps.push_back(std::move(m));
+    }
+  }
+private:
+  template<class T, typename... Args>
+  friend boost::intrusive_ptr<T> ceph::make_message(Args&&... args);
+};
+
+#endif
@@ -80,18 +80,37 @@ void DispatchQueue::fast_preprocess(const ref_t<Message>& m)
 
 void DispatchQueue::enqueue(const ref_t<Message>& m, int priority, uint64_t id)
 {
-  std::lock_guard l{lock};
   if (stop) {
     return;
   }
   ldout(cct,20) << "queue " << m << " prio " << priority << dendl;
-  add_arrival(m);
-  if (priority >= CEPH_MSG_PRIO_LOW) {
-    mqueue.enqueue_strict(id, priority, QueueItem(m));
-  } else {
-    mqueue.enqueue(id, priority, m->get_cost(), QueueItem(m));
+  staged.push(StagedItem{ref_t<Message>(m).detach(), priority, id});
+  ++num_staged;
+  // Only wake the dispatch thread if it is (about to be) asleep.  It sets
+  // dispatch_waiting before it re-checks num_staged, so one of us is
+  // guaranteed to see the other's store.
+  if (dispatch_waiting) {
+    std::lock_guard l{lock};
+    cond.notify_all();
+  }
+}
+
+void DispatchQueue::drain_staged()
+{
+  ceph_assert(ceph_mutex_is_locked(lock));
+  StagedItem item;
+  while (num_staged && staged.pop(item)) {
+    --num_staged;
+    ref_t<Message> m(item.m, false);  // adopt the staged reference
+    if (!stop) {
+      add_arrival(m);
+      if (item.priority >= CEPH_MSG_PRIO_LOW) {
+	mqueue.enqueue_strict(item.id, item.priority, QueueItem(m));
+      } else {
+	mqueue.enqueue(item.id, item.priority, m->get_cost(), QueueItem(m));
+      }
+    }
   }
-  cond.notify_all();
 }
 
 void DispatchQueue::local_delivery(const ref_t<Message>& m, int priority)
@@ -155,6 +174,7 @@ void DispatchQueue::entry()
 {
   std::unique_lock l{lock};
   while (true) {
+    drain_staged();
     while (!mqueue.empty()) {
       QueueItem qitem = mqueue.dequeue();
       if (!qitem.is_code())
@@ -202,17 +222,22 @@ void DispatchQueue::entry()
       }
 
       l.lock();
+      drain_staged();
     }
     if (stop)
       break;
 
     // wait for something to be put on queue
-    cond.wait(l);
+    dispatch_waiting = true;
+    if (!num_staged)
+      cond.wait(l);
+    dispatch_waiting = false;
   }
 }
 
 void DispatchQueue::discard_queue(uint64_t id) {
   std::lock_guard l{lock};
+  drain_staged();
   list<QueueItem> removed;
   mqueue.remove_by_class(id, &removed);
   for (list<QueueItem>::iterator i = removed.begin();
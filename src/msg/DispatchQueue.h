@@ -19,6 +19,7 @@
 #include <map>
 #include <queue>
 #include <boost/intrusive_ptr.hpp>
+#include <boost/lockfree/queue.hpp>
 #include "include/ceph_assert.h"
 #include "common/Throttle.h"
 #include "common/ceph_mutex.h"
@@ -86,6 +87,30 @@ class DispatchQueue {
     marrival_map.erase(it);
   }
 
+  /**
+   * Messages handed to enqueue() are staged here without taking lock, so
+   * that the messenger workers never contend with each other or with the
+   * dispatch thread.  The dispatch thread (or anyone else holding lock)
+   * moves them into mqueue in batches; the PrioritizedQueue then applies
+   * the usual strict/token-bucket ordering across priorities and
+   * connections.  Connection events drain the staged messages before
+   * they are queued, so they never overtake them.
+   *
+   * Items are stored by value (the queue needs them trivially copyable,
+   * so the message reference is held as a raw pointer) in nodes that the
+   * queue recycles through its freelist.
+   */
+  struct StagedItem {
+    Message *m;  ///< holds a reference
+    int priority;
+    uint64_t id;
+  };
+  boost::lockfree::queue<StagedItem> staged;
+  std::atomic<unsigned> num_staged = {0};
+  /// set by the dispatch thread (under lock) before it waits on cond
+  std::atomic<bool> dispatch_waiting = {false};
+  void drain_staged();
+
   std::atomic<uint64_t> next_id;
     
   enum { D_CONNECT = 1, D_ACCEPT, D_BAD_REMOTE_RESET, D_BAD_RESET, D_CONN_REFUSED, D_NUM_CODES };
@@ -125,7 +150,7 @@ class DispatchQueue {
   /// Throttle preventing us from building up a big backlog waiting for dispatch
   Throttle dispatch_throttler;
 
-  bool stop;
+  std::atomic<bool> stop;
   void local_delivery(const ref_t<Message>& m, int priority);
   void local_delivery(Message* m, int priority) {
     return local_delivery(ref_t<Message>(m, false), priority); /* consume ref */
@@ -136,7 +161,7 @@ class DispatchQueue {
 
   int get_queue_len() const {
     std::lock_guard l{lock};
-    return mqueue.length();
+    return mqueue.length() + num_staged;
   }
 
   /**
@@ -150,6 +175,8 @@ class DispatchQueue {
     std::lock_guard l{lock};
     if (stop)
       return;
+    // keep the event behind messages staged before it
+    drain_staged();
     mqueue.enqueue_strict(
       0,
       CEPH_MSG_PRIO_HIGHEST,
@@ -160,6 +187,8 @@ class DispatchQueue {
     std::lock_guard l{lock};
     if (stop)
       return;
+    // keep the event behind messages staged before it
+    drain_staged();
     mqueue.enqueue_strict(
       0,
       CEPH_MSG_PRIO_HIGHEST,
@@ -170,6 +199,8 @@ class DispatchQueue {
     std::lock_guard l{lock};
     if (stop)
       return;
+    // keep the event behind messages staged before it
+    drain_staged();
     mqueue.enqueue_strict(
       0,
       CEPH_MSG_PRIO_HIGHEST,
@@ -180,6 +211,8 @@ class DispatchQueue {
     std::lock_guard l{lock};
     if (stop)
       return;
+    // keep the event behind messages staged before it
+    drain_staged();
     mqueue.enqueue_strict(
       0,
       CEPH_MSG_PRIO_HIGHEST,
@@ -190,6 +223,8 @@ class DispatchQueue {
     std::lock_guard l{lock};
     if (stop)
       return;
+    // keep the event behind messages staged before it
+    drain_staged();
     mqueue.enqueue_strict(
       0,
       CEPH_MSG_PRIO_HIGHEST,
@@ -223,6 +258,7 @@ class DispatchQueue {
       lock(ceph::make_mutex("Messenger::DispatchQueue::lock" + name)),
       mqueue(cct->_conf->ms_pq_max_tokens_per_priority,
 	     cct->_conf->ms_pq_min_cost),
+      staged(128),
       next_id(1),
       dispatch_thread(this),
       local_delivery_lock(ceph::make_mutex("Messenger::DispatchQueue::local_delivery_lock" + name)),
@@ -233,6 +269,10 @@ class DispatchQueue {
       stop(false)
     {}
   ~DispatchQueue() {
+    // anything enqueued after shutdown() was never accepted
+    StagedItem item;
+    while (staged.pop(item))
+      item.m->put();
     ceph_assert(mqueue.empty());
     ceph_assert(marrival.empty());
     ceph_assert(local_messages.empty());
@@ -124,6 +124,7 @@
 #include "messages/MClientReclaim.h"
 #include "messages/MClientReclaimReply.h"
 #include "messages/MClientCaps.h"
+#include "messages/MClientCapsBatch.h"
 #include "messages/MClientCapRelease.h"
 #include "messages/MClientLease.h"
 #include "messages/MClientSnap.h"
@@ -668,6 +669,9 @@ Message *decode_message(CephContext *cct,
   case CEPH_MSG_CLIENT_CAPS:
     m = make_message<MClientCaps>();
     break;
+  case CEPH_MSG_CLIENT_CAPS_BATCH:
+    m = make_message<MClientCapsBatch>();
+    break;
   case CEPH_MSG_CLIENT_CAPRELEASE:
     m = make_message<MClientCapRelease>();
     break;
@@ -369,6 +369,9 @@ void AsyncConnection::process() {
 
   ldout(async_msgr->cct, 20) << __func__ << dendl;
 
+  if (cs)
+    cs.drain_error_queue();
+
   switch (state) {
     case STATE_NONE: {
       ldout(async_msgr->cct, 20) << __func__ << " enter none state" << dendl;
@@ -61,15 +61,19 @@ Processor::Processor(AsyncMessenger *r, Worker *w, CephContext *c)
 
 int Processor::bind(const entity_addrvec_t &bind_addrs,
 		    const set<int>& avoid_ports,
-		    entity_addrvec_t* bound_addrs)
+		    entity_addrvec_t* bound_addrs,
+		    bool join)
 {
   const auto& conf = msgr->cct->_conf;
   // bind to socket(s)
-  ldout(msgr->cct, 10) << __func__ << " " << bind_addrs << dendl;
+  ldout(msgr->cct, 10) << __func__ << " " << bind_addrs
+		       << (join ? " (join)" : "") << dendl;
 
   SocketOptions opts;
   opts.nodelay = msgr->cct->_conf->ms_tcp_nodelay;
   opts.rcbuf_size = msgr->cct->_conf->ms_tcp_rcvbuf;
+  opts.reuseport = conf.get_val<bool>("ms_async_reuseport");
+  opts.reuseport_join = join;
 
   listen_sockets.resize(bind_addrs.v.size());
   *bound_addrs = bind_addrs;
@@ -401,7 +405,9 @@ int AsyncMessenger::bindv(const entity_addrvec_t &bind_addrs)
   entity_addrvec_t bound_addrs;
   unsigned i = 0;
   for (auto &&p : processors) {
-    int r = p->bind(bind_addrs, avoid_ports, &bound_addrs);
+    // the other workers listen on exactly the ports the first one got
+    int r = i == 0 ? p->bind(bind_addrs, avoid_ports, &bound_addrs) :
+      p->bind(entity_addrvec_t(bound_addrs), avoid_ports, &bound_addrs, true);
     if (r) {
       // Note: this is related to local tcp listen table problem.
       // Posix(default kernel implementation) backend shares listen table
@@ -446,7 +452,8 @@ int AsyncMessenger::rebind(const set<int>& avoid_ports)
 		 << " and avoid ports " << new_avoid << dendl;
   unsigned i = 0;
   for (auto &&p : processors) {
-    int r = p->bind(bind_addrs, avoid_ports, &bound_addrs);
+    int r = i == 0 ? p->bind(bind_addrs, avoid_ports, &bound_addrs) :
+      p->bind(entity_addrvec_t(bound_addrs), avoid_ports, &bound_addrs, true);
     if (r) {
       ceph_assert(i == 0);
       return r;
@@ -58,7 +58,8 @@ class Processor {
   void stop();
   int bind(const entity_addrvec_t &bind_addrs,
 	   const set<int>& avoid_ports,
-	   entity_addrvec_t* bound_addrs);
+	   entity_addrvec_t* bound_addrs,
+	   bool join = false);
   void start();
   void accept();
 };
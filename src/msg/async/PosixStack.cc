@@ -21,6 +21,11 @@
 #include <errno.h>
 
 #include <algorithm>
+#include <deque>
+
+#ifdef __linux__
+#include <linux/errqueue.h>
+#endif
 
 #include "PosixStack.h"
 
@@ -37,15 +42,62 @@
 #undef dout_prefix
 #define dout_prefix *_dout << "PosixStack "
 
+#if defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY) && defined(SO_EE_ORIGIN_ZEROCOPY)
+#define HAVE_MSG_ZEROCOPY 1
+#endif
+
+#ifdef HAVE_MSG_ZEROCOPY
+void PosixZerocopyState::reap(int fd)
+{
+  while (!pending.empty()) {
+    struct msghdr msg;
+    char control[CMSG_SPACE(sizeof(struct sock_extended_err))];
+    // FIPS zeroization audit 20191115: this memset is not security related.
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    if (::recvmsg(fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0)
+      return;
+    for (struct cmsghdr *cm = CMSG_FIRSTHDR(&msg); cm;
+         cm = CMSG_NXTHDR(&msg, cm)) {
+      if (!((cm->cmsg_level == SOL_IP && cm->cmsg_type == IP_RECVERR) ||
+            (cm->cmsg_level == SOL_IPV6 && cm->cmsg_type == IPV6_RECVERR)))
+        continue;
+      auto serr = reinterpret_cast<struct sock_extended_err*>(CMSG_DATA(cm));
+      if (serr->ee_errno != 0 || serr->ee_origin != SO_EE_ORIGIN_ZEROCOPY)
+        continue;
+      if (serr->ee_code & SO_EE_CODE_ZEROCOPY_COPIED)
+        copied = true;
+      // ids wrap; [ee_info, ee_data] completed, and TCP completes in order
+      uint32_t hi = serr->ee_data;
+      while (!pending.empty() &&
+             (int32_t)(hi - pending.front().first) >= 0) {
+        pending.pop_front();
+      }
+    }
+  }
+}
+#else
+void PosixZerocopyState::reap(int fd) {}
+#endif
+
 class PosixConnectedSocketImpl final : public ConnectedSocketImpl {
   NetHandler &handler;
   int _fd;
   entity_addr_t sa;
   bool connected;
+  PosixWorker *worker;
+
+  size_t zerocopy_min_size;
+  bool zerocopy_enabled = false;
+  PosixZerocopyState zc;
 
  public:
-  explicit PosixConnectedSocketImpl(NetHandler &h, const entity_addr_t &sa, int f, bool connected)
-      : handler(h), _fd(f), sa(sa), connected(connected) {}
+  explicit PosixConnectedSocketImpl(NetHandler &h, const entity_addr_t &sa, int f, bool connected,
+                                    PosixWorker *w = nullptr,
+                                    size_t zerocopy_min_size = 0)
+      : handler(h), _fd(f), sa(sa), connected(connected), worker(w),
+        zerocopy_min_size(zerocopy_min_size) {}
 
   int is_connected() override {
     if (connected)
@@ -69,24 +121,49 @@ class PosixConnectedSocketImpl final : public ConnectedSocketImpl {
     return r;
   }
 
+  // completions raise EPOLLERR, which the event loop reports as readable;
+  // the connection calls this on every readable event, whether or not
+  // the protocol goes on to read()
+  void drain_error_queue() override {
+    if (zc.empty())
+      return;
+    zc.reap(_fd);
+    if (zc.copied) {
+      // the kernel had to copy anyway (e.g. loopback); stop paying for
+      // page pinning and notifications on this socket
+      zerocopy_min_size = 0;
+    }
+  }
+
   // return the sent length
   // < 0 means error occurred
-  static ssize_t do_sendmsg(int fd, struct msghdr &msg, unsigned len, bool more)
+  // *syscalls is bumped for every sendmsg() issued, and *calls for every
+  // MSG_ZEROCOPY sendmsg() that queued data
+  static ssize_t do_sendmsg(int fd, struct msghdr &msg, unsigned len, bool more,
+                            unsigned *syscalls, int flags = 0,
+                            unsigned *calls = nullptr)
   {
     size_t sent = 0;
     while (1) {
       MSGR_SIGPIPE_STOPPER;
       ssize_t r;
-      r = ::sendmsg(fd, &msg, MSG_NOSIGNAL | (more ? MSG_MORE : 0));
+      ++*syscalls;
+      r = ::sendmsg(fd, &msg, MSG_NOSIGNAL | (more ? MSG_MORE : 0) | flags);
       if (r < 0) {
         if (errno == EINTR) {
           continue;
         } else if (errno == EAGAIN) {
           break;
+        } else if (errno == ENOBUFS && (flags & MSG_ZEROCOPY)) {
+          // out of optmem for zerocopy notifications; copy this one
+          flags &= ~MSG_ZEROCOPY;
+          continue;
         }
         return -errno;
       }
 
+      if (calls && r > 0 && (flags & MSG_ZEROCOPY))
+        ++*calls;
       sent += r;
       if (len == sent) break;
 
@@ -106,7 +183,34 @@ class PosixConnectedSocketImpl final : public ConnectedSocketImpl {
     return (ssize_t)sent;
   }
 
+#ifdef HAVE_MSG_ZEROCOPY
+  bool maybe_enable_zerocopy() {
+    if (zerocopy_enabled)
+      return true;
+    if (!zerocopy_min_size || !connected)
+      return false;
+    int on = 1;
+    if (::setsockopt(_fd, SOL_SOCKET, SO_ZEROCOPY, &on, sizeof(on)) < 0) {
+      zerocopy_min_size = 0;  // not supported here, don't try again
+      return false;
+    }
+    zerocopy_enabled = true;
+    return true;
+  }
+#else
+  bool maybe_enable_zerocopy() { return false; }
+#endif
+
   ssize_t send(bufferlist &bl, bool more) override {
+    drain_error_queue();
+    int flags = 0;
+#ifdef HAVE_MSG_ZEROCOPY
+    if (zerocopy_min_size && bl.length() >= zerocopy_min_size &&
+        maybe_enable_zerocopy())
+      flags = MSG_ZEROCOPY;
+#endif
+    unsigned zerocopy_calls = 0;
+    unsigned syscalls = 0;
     size_t sent_bytes = 0;
     auto pb = std::cbegin(bl.buffers());
     uint64_t left_pbrs = bl.get_num_buffers();
@@ -126,9 +230,12 @@ class PosixConnectedSocketImpl final : public ConnectedSocketImpl {
 	msglen += pb->length();
 	++pb;
       }
-      ssize_t r = do_sendmsg(_fd, msg, msglen, left_pbrs || more);
-      if (r < 0)
+      ssize_t r = do_sendmsg(_fd, msg, msglen, left_pbrs || more, &syscalls,
+                             flags, flags ? &zerocopy_calls : nullptr);
+      if (r < 0) {
+        count_send_calls(syscalls);
         return r;
+      }
 
       // "r" is the remaining length
       sent_bytes += r;
@@ -143,17 +250,37 @@ class PosixConnectedSocketImpl final : public ConnectedSocketImpl {
         bl.splice(sent_bytes, bl.length()-sent_bytes, &swapped);
         bl.swap(swapped);
       } else {
-        bl.clear();
+        swapped.swap(bl);
+      }
+      // "swapped" now holds what was sent
+      if (zerocopy_calls) {
+        zc.next_id += zerocopy_calls;
+        zc.pending.emplace_back(zc.next_id - 1, std::move(swapped));
       }
     }
 
+    count_send_calls(syscalls);
     return static_cast<ssize_t>(sent_bytes);
   }
+  void count_send_calls(unsigned syscalls) {
+    if (worker && syscalls)
+      worker->get_perf_counter()->inc(l_msgr_send_calls, syscalls);
+  }
   void shutdown() override {
     ::shutdown(_fd, SHUT_RDWR);
   }
   void close() override {
+    zc.reap(_fd);
+    if (!zc.empty() && worker) {
+      // the kernel may still transmit from our pages; let the data and
+      // FIN go out, and keep the fd and the pages until it is done
+      ::shutdown(_fd, SHUT_RDWR);
+      worker->linger_zerocopy(_fd, std::move(zc));
+      zc.pending.clear();
+      return;
+    }
     ::close(_fd);
+    zc.pending.clear();
   }
   int fd() const override {
     return _fd;
@@ -208,15 +335,77 @@ int PosixServerSocketImpl::accept(ConnectedSocket *sock, const SocketOptions &op
   out->set_sockaddr((sockaddr*)&ss);
   handler.set_priority(sd, opt.priority, out->get_family());
 
-  std::unique_ptr<PosixConnectedSocketImpl> csi(new PosixConnectedSocketImpl(handler, *out, sd, true));
+  std::unique_ptr<PosixConnectedSocketImpl> csi(new PosixConnectedSocketImpl(
+    handler, *out, sd, true, static_cast<PosixWorker*>(w),
+    w->cct->_conf.get_val<Option::size_t>("ms_async_zerocopy_min_size")));
   *sock = ConnectedSocket(std::move(csi));
   return 0;
 }
 
+class C_reap_zerocopy : public EventCallback {
+  PosixWorker *worker;
+
+ public:
+  explicit C_reap_zerocopy(PosixWorker *w): worker(w) {}
+  void do_request(uint64_t fd) override {
+    worker->reap_lingering(fd);
+  }
+};
+
+PosixWorker::PosixWorker(CephContext *c, unsigned i)
+  : Worker(c, i), net(c), zerocopy_reaper(new C_reap_zerocopy(this))
+{
+}
+
+PosixWorker::~PosixWorker()
+{
+  delete zerocopy_reaper;
+}
+
 void PosixWorker::initialize()
 {
 }
 
+void PosixWorker::destroy()
+{
+  // the event loop has stopped; nobody will read the completions now
+  for (auto& [fd, zc] : zerocopy_lingering) {
+    center.delete_file_event(fd, EVENT_READABLE);
+    ::close(fd);
+  }
+  zerocopy_lingering.clear();
+}
+
+void PosixWorker::linger_zerocopy(int fd, PosixZerocopyState &&zc)
+{
+  if (!center.in_thread()) {
+    center.submit_to(
+      center.get_id(),
+      [this, fd, zc=std::move(zc)]() mutable {
+	linger_zerocopy(fd, std::move(zc));
+      }, true);
+    return;
+  }
+  ldout(cct, 10) << __func__ << " fd " << fd << " has " << zc.pending.size()
+		 << " zerocopy sends in flight" << dendl;
+  zerocopy_lingering[fd] = std::move(zc);
+  center.create_file_event(fd, EVENT_READABLE, zerocopy_reaper);
+}
+
+void PosixWorker::reap_lingering(int fd)
+{
+  auto p = zerocopy_lingering.find(fd);
+  if (p == zerocopy_lingering.end())
+    return;
+  p->second.reap(fd);
+  if (!p->second.empty())
+    return;
+  ldout(cct, 10) << __func__ << " fd " << fd << " zerocopy sends done" << dendl;
+  center.delete_file_event(fd, EVENT_READABLE);
+  ::close(fd);
+  zerocopy_lingering.erase(p);
+}
+
 int PosixWorker::listen(entity_addr_t &sa,
 			unsigned addr_slot,
 			const SocketOptions &opt,
@@ -239,6 +428,39 @@ int PosixWorker::listen(entity_addr_t &sa,
     return -errno;
   }
 
+#ifdef SO_REUSEPORT
+  if (opt.reuseport) {
+    if (!opt.reuseport_join) {
+      // any process of the same user may join a SO_REUSEPORT group, so
+      // make sure nobody (e.g. another daemon on this host) already
+      // holds the port before we claim it.
+      int probe_sd = net.create_socket(sa.get_family(), true);
+      if (probe_sd < 0) {
+        ::close(listen_sd);
+        return -errno;
+      }
+      r = ::bind(probe_sd, sa.get_sockaddr(), sa.get_sockaddr_len());
+      if (r < 0) {
+        r = -errno;
+        ldout(cct, 10) << __func__ << " unable to bind to " << sa.get_sockaddr()
+                       << ": " << cpp_strerror(r) << dendl;
+        ::close(probe_sd);
+        ::close(listen_sd);
+        return r;
+      }
+      ::close(probe_sd);
+    }
+    int on = 1;
+    if (::setsockopt(listen_sd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) < 0) {
+      r = -errno;
+      lderr(cct) << __func__ << " setsockopt SO_REUSEPORT failed: "
+                 << cpp_strerror(r) << dendl;
+      ::close(listen_sd);
+      return r;
+    }
+  }
+#endif
+
   r = ::bind(listen_sd, sa.get_sockaddr(), sa.get_sockaddr_len());
   if (r < 0) {
     r = -errno;
@@ -277,11 +499,16 @@ int PosixWorker::connect(const entity_addr_t &addr, const SocketOptions &opts, C
 
   net.set_priority(sd, opts.priority, addr.get_family());
   *socket = ConnectedSocket(
-      std::unique_ptr<PosixConnectedSocketImpl>(new PosixConnectedSocketImpl(net, addr, sd, !opts.nonblock)));
+      std::unique_ptr<PosixConnectedSocketImpl>(new PosixConnectedSocketImpl(
+	net, addr, sd, !opts.nonblock, this,
+	cct->_conf.get_val<Option::size_t>("ms_async_zerocopy_min_size"))));
   return 0;
 }
 
 PosixNetworkStack::PosixNetworkStack(CephContext *c, const string &t)
     : NetworkStack(c, t)
 {
+#ifdef SO_REUSEPORT
+  reuseport = cct->_conf.get_val<bool>("ms_async_reuseport");
+#endif
 }
@@ -17,19 +17,43 @@
 #ifndef CEPH_MSG_ASYNC_POSIXSTACK_H
 #define CEPH_MSG_ASYNC_POSIXSTACK_H
 
+#include <deque>
+#include <map>
 #include <thread>
 
+#include "include/buffer.h"
 #include "msg/msg_types.h"
 #include "msg/async/net_handler.h"
 
 #include "Stack.h"
 
+// MSG_ZEROCOPY: sendmsg() calls that were done with MSG_ZEROCOPY are
+// numbered by the kernel, and completions come back as id ranges on the
+// socket error queue.  Until then the kernel may still read from the
+// pages, so keep a reference to them.
+struct PosixZerocopyState {
+  uint32_t next_id = 0;
+  bool copied = false;  ///< kernel reported it had to copy anyway
+  std::deque<std::pair<uint32_t, bufferlist>> pending;
+
+  bool empty() const { return pending.empty(); }
+  /// drain the error queue of fd, releasing completed sends
+  void reap(int fd);
+};
+
 class PosixWorker : public Worker {
   NetHandler net;
+  // sockets closed while zerocopy sends were in flight; the fd stays open
+  // (shut down) until the kernel has released our pages
+  std::map<int, PosixZerocopyState> zerocopy_lingering;
+  EventCallbackRef zerocopy_reaper;
   void initialize() override;
  public:
-  PosixWorker(CephContext *c, unsigned i)
-      : Worker(c, i), net(c) {}
+  PosixWorker(CephContext *c, unsigned i);
+  ~PosixWorker() override;
+  void destroy() override;
+  void linger_zerocopy(int fd, PosixZerocopyState &&zc);
+  void reap_lingering(int fd);
   int listen(entity_addr_t &sa,
 	     unsigned addr_slot,
 	     const SocketOptions &opt,
@@ -39,10 +63,15 @@ class PosixWorker : public Worker {
 
 class PosixNetworkStack : public NetworkStack {
   vector<std::thread> threads;
+  bool reuseport = false;
 
  public:
   explicit PosixNetworkStack(CephContext *c, const string &t);
 
+  // with SO_REUSEPORT every worker listens on its own socket, and the
+  // kernel balances incoming connections across them.
+  bool support_local_listen_table() const override { return reuseport; }
+
   void spawn_worker(unsigned i, std::function<void ()> &&func) override {
     threads.resize(i+1);
     threads[i] = std::thread(func);
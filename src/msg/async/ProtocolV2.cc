@@ -10,6 +10,7 @@
 #include "common/ceph_crypto.h"
 #include "common/errno.h"
 #include "include/random.h"
+#include "include/str_list.h"
 #include "auth/AuthClient.h"
 #include "auth/AuthServer.h"
 
@@ -81,6 +82,7 @@ if(connection->interceptor) { \
 ProtocolV2::ProtocolV2(AsyncConnection *connection)
     : Protocol(2, connection),
       state(NONE),
+      peer_supported_features(0),
       peer_required_features(0),
       client_cookie(0),
       server_cookie(0),
@@ -93,7 +95,10 @@ ProtocolV2::ProtocolV2(AsyncConnection *connection)
       can_write(false),
       bannerExchangeCallback(nullptr),
       next_tag(static_cast<Tag>(0)),
-      keepalive(false) {
+      keepalive(false),
+      cork_max_bytes(cct->_conf.get_val<Option::size_t>("ms_async_cork_max_bytes")),
+      cork_max_latency(std::chrono::microseconds(
+        cct->_conf.get_val<uint64_t>("ms_async_cork_max_us"))) {
 }
 
 ProtocolV2::~ProtocolV2() {
@@ -275,7 +280,7 @@ void ProtocolV2::reset_throttle() {
   }
   if (state > THROTTLE_BYTES && state <= THROTTLE_DONE) {
     if (connection->policy.throttler_bytes) {
-      const size_t cur_msg_size = get_current_msg_size();
+      const size_t cur_msg_size = get_current_msg_size() + rx_throttle_delta;
       ldout(cct, 10) << __func__ << " releasing " << cur_msg_size
                      << " bytes to policy throttler "
                      << connection->policy.throttler_bytes->get_current() << "/"
@@ -284,7 +289,7 @@ void ProtocolV2::reset_throttle() {
     }
   }
   if (state > THROTTLE_DISPATCH_QUEUE && state <= THROTTLE_DONE) {
-    const size_t cur_msg_size = get_current_msg_size();
+    const size_t cur_msg_size = get_current_msg_size() + rx_throttle_delta;
     ldout(cct, 10)
         << __func__ << " releasing " << cur_msg_size
         << " bytes to dispatch_queue throttler "
@@ -292,6 +297,7 @@ void ProtocolV2::reset_throttle() {
         << connection->dispatch_queue->dispatch_throttler.get_max() << dendl;
     connection->dispatch_queue->dispatch_throttle_release(cur_msg_size);
   }
+  rx_throttle_delta = 0;
 }
 
 CtPtr ProtocolV2::_fault() {
@@ -498,6 +504,95 @@ ProtocolV2::out_queue_entry_t ProtocolV2::_get_next_outgoing() {
   return out_entry;
 }
 
+void ProtocolV2::init_tx_compression()
+{
+  tx_compression_checked = true;
+  tx_compressor.reset();
+
+  if (!HAVE_MSGR2_FEATURE(peer_supported_features, COMPRESSION)) {
+    return;
+  }
+  const auto& conf = cct->_conf;
+  if (conf.get_val<std::string>("ms_compress_mode") != "force") {
+    return;
+  }
+  if (auth_meta->is_mode_secure() && !conf.get_val<bool>("ms_compress_secure")) {
+    return;
+  }
+  // both ends have to be of a listed type, e.g. osd<->osd only
+  const auto types = get_str_list(
+    conf.get_val<std::string>("ms_compress_entity_types"));
+  auto listed = [&types](int type) {
+    return std::find(types.begin(), types.end(),
+		     ceph_entity_type_name(type)) != types.end();
+  };
+  if (!listed(messenger->get_mytype()) ||
+      !listed(connection->get_peer_type())) {
+    return;
+  }
+
+  const auto alg = conf.get_val<std::string>("ms_compress_algorithm");
+  tx_compressor = Compressor::create(cct, alg);
+  if (!tx_compressor) {
+    lderr(cct) << __func__ << " unable to load compressor " << alg
+	       << ", not compressing" << dendl;
+    return;
+  }
+  tx_compression_min_size = conf.get_val<Option::size_t>("ms_compress_min_size");
+  ldout(cct, 10) << __func__ << " compressing messages of at least "
+		 << tx_compression_min_size << " bytes with " << alg << dendl;
+}
+
+void ProtocolV2::adjust_rx_throttle(int64_t delta)
+{
+  if (!delta) {
+    return;
+  }
+  if (connection->policy.throttler_bytes) {
+    if (delta > 0) {
+      connection->policy.throttler_bytes->take(delta);
+    } else {
+      connection->policy.throttler_bytes->put(-delta);
+    }
+  }
+  if (delta > 0) {
+    connection->dispatch_queue->dispatch_throttler.take(delta);
+  } else {
+    connection->dispatch_queue->dispatch_throttle_release(-delta);
+  }
+  rx_throttle_delta += delta;
+}
+
+bool ProtocolV2::decompress_message_segments(size_t *msg_size)
+{
+  const int64_t raw_size = MessageFrame::get_decompressed_length(
+    rx_segments_data,
+    cct->_conf.get_val<Option::size_t>("ms_compress_max_raw_size"));
+  if (raw_size < 0) {
+    ldout(cct, 1) << __func__ << " rejecting compressed message: "
+		  << cpp_strerror(raw_size) << dendl;
+    return false;
+  }
+  // the throttles were charged with the on-wire size before the segments
+  // were read, but the message holds, and releases, the raw size
+  adjust_rx_throttle(raw_size - static_cast<int64_t>(*msg_size));
+  *msg_size = raw_size;
+
+  int r = MessageFrame::decompress(cct, rx_segments_data, rx_compressors);
+  if (r < 0) {
+    ldout(cct, 1) << __func__ << " decompressing message failed: "
+		  << cpp_strerror(r) << dendl;
+    return false;
+  }
+  for (std::size_t idx = SegmentIndex::Msg::FRONT;
+       idx < rx_segments_data.size(); idx++) {
+    if (rx_segments_desc[idx].alignment > segment_t::DEFAULT_ALIGNMENT) {
+      rx_segments_data[idx].rebuild_aligned(rx_segments_desc[idx].alignment);
+    }
+  }
+  return true;
+}
+
 ssize_t ProtocolV2::write_message(Message *m, bool more) {
   FUNCTRACE(cct);
   ceph_assert(connection->center->in_thread());
@@ -524,6 +619,13 @@ ssize_t ProtocolV2::write_message(Message *m, bool more) {
 			     m->get_payload(),
 			     m->get_middle(),
 			     m->get_data());
+  if (!tx_compression_checked) {
+    init_tx_compression();
+  }
+  if (tx_compressor) {
+    message.compress(*tx_compressor, tx_compression_min_size,
+		     peer_supported_features);
+  }
   connection->outgoing_bl.append(message.get_buffer(session_stream_handlers));
 
   ldout(cct, 5) << __func__ << " sending message m=" << m
@@ -534,16 +636,22 @@ ssize_t ProtocolV2::write_message(Message *m, bool more) {
                  << " src=" << entity_name_t(messenger->get_myname())
                  << " off=" << header2.data_off
                  << dendl;
-  ssize_t total_send_size = connection->outgoing_bl.length();
-  ssize_t rc = connection->_try_send(more);
-  if (rc < 0) {
-    ldout(cct, 1) << __func__ << " error sending " << m << ", "
-                  << cpp_strerror(rc) << dendl;
+  ssize_t rc = 0;
+  if (more && connection->outgoing_bl.length() < cork_max_bytes &&
+      ceph::mono_clock::now() - cork_start < cork_max_latency) {
+    // more messages are queued behind this one; let them share the write
+    ldout(cct, 20) << __func__ << " corked " << m << ", "
+                   << connection->outgoing_bl.length() << " bytes pending"
+                   << dendl;
   } else {
-    connection->logger->inc(
-        l_msgr_send_bytes, total_send_size - connection->outgoing_bl.length());
-    ldout(cct, 10) << __func__ << " sending " << m
-                   << (rc ? " continuely." : " done.") << dendl;
+    rc = flush_outgoing(more);
+    if (rc < 0) {
+      ldout(cct, 1) << __func__ << " error sending " << m << ", "
+                    << cpp_strerror(rc) << dendl;
+    } else {
+      ldout(cct, 10) << __func__ << " sending " << m
+                     << (rc ? " continuely." : " done.") << dendl;
+    }
   }
 
 #if defined(WITH_EVENTTRACE)
@@ -557,6 +665,17 @@ ssize_t ProtocolV2::write_message(Message *m, bool more) {
   return rc;
 }
 
+ssize_t ProtocolV2::flush_outgoing(bool more) {
+  ssize_t total_send_size = connection->outgoing_bl.length();
+  ssize_t rc = connection->_try_send(more);
+  if (rc >= 0) {
+    connection->logger->inc(
+        l_msgr_send_bytes, total_send_size - connection->outgoing_bl.length());
+  }
+  cork_start = ceph::mono_clock::now();
+  return rc;
+}
+
 void ProtocolV2::append_keepalive() {
   ldout(cct, 10) << __func__ << dendl;
   auto keepalive_frame = KeepAliveFrame::Encode();
@@ -608,6 +727,7 @@ void ProtocolV2::write_event() {
     }
 
     auto start = ceph::mono_clock::now();
+    cork_start = start;
     bool more;
     do {
       const auto out_entry = _get_next_outgoing();
@@ -660,9 +780,9 @@ void ProtocolV2::write_event() {
                        << " messages" << dendl;
         ack_left -= left;
         left = ack_left;
-        r = connection->_try_send(left);
+        r = flush_outgoing(left);
       } else if (is_queued()) {
-        r = connection->_try_send();
+        r = flush_outgoing(false);
       }
     }
     connection->write_lock.unlock();
@@ -908,7 +1028,9 @@ CtPtr ProtocolV2::_handle_peer_banner_payload(rx_buffer_t &&buffer, int r) {
     return nullptr;
   }
 
+  this->peer_supported_features = peer_supported_features;
   this->peer_required_features = peer_required_features;
+  tx_compression_checked = false;
   if (this->peer_required_features == 0) {
     this->connection_features = msgr2_required;
   }
@@ -1091,6 +1213,15 @@ CtPtr ProtocolV2::handle_read_frame_preamble_main(rx_buffer_t &&buffer, int r) {
     }
 
     next_tag = static_cast<Tag>(main_preamble.tag);
+    next_frame_flags = main_preamble.flags;
+    if ((next_frame_flags & ~FRAME_EARLY_FLAGS_COMPRESSED) ||
+	((next_frame_flags & FRAME_EARLY_FLAGS_COMPRESSED) &&
+	 next_tag != Tag::MESSAGE)) {
+      ldout(cct, 1) << __func__ << " unexpected frame flags="
+		    << std::hex << (int)next_frame_flags << std::dec
+		    << " tag=" << (int)main_preamble.tag << dendl;
+      return _fault();
+    }
 
     rx_segments_desc.clear();
     rx_segments_data.clear();
@@ -1388,6 +1519,11 @@ CtPtr ProtocolV2::handle_message() {
 
   // we need to get the size before std::moving segments data
   const size_t cur_msg_size = get_current_msg_size();
+  size_t msg_size = cur_msg_size;
+  if ((next_frame_flags & FRAME_EARLY_FLAGS_COMPRESSED) &&
+      !decompress_message_segments(&msg_size)) {
+    return _fault();
+  }
   auto msg_frame = MessageFrame::Decode(std::move(rx_segments_data));
 
   // XXX: paranoid copy just to avoid oops
@@ -1430,6 +1566,7 @@ CtPtr ProtocolV2::handle_message() {
     return _fault();
   } else {
     state = READ_MESSAGE_COMPLETE;
+    rx_throttle_delta = 0;
   }
 
   INTERCEPT(17);
@@ -1439,7 +1576,7 @@ CtPtr ProtocolV2::handle_message() {
 
   // store reservation size in message, so we don't get confused
   // by messages entering the dispatch queue through other paths.
-  message->set_dispatch_throttle_size(cur_msg_size);
+  message->set_dispatch_throttle_size(msg_size);
 
   message->set_recv_stamp(recv_stamp);
   message->set_throttle_stamp(throttle_stamp);
@@ -2696,6 +2833,8 @@ CtPtr ProtocolV2::reuse_connection(const AsyncConnectionRef& existing,
     existing->set_features(connection_features);
   }
   exproto->peer_global_seq = peer_global_seq;
+  exproto->peer_supported_features = peer_supported_features;
+  exproto->tx_compression_checked = false;
 
   ceph_assert(connection->center->in_thread());
   auto temp_cs = std::move(connection->cs);
@@ -73,6 +73,7 @@ public:
 private:
   entity_name_t peer_name;
   State state;
+  uint64_t peer_supported_features;
   uint64_t peer_required_features;
 
   uint64_t client_cookie;
@@ -102,6 +103,7 @@ private:
   boost::container::static_vector<ceph::bufferlist,
 				  ceph::msgr::v2::MAX_NUM_SEGMENTS> rx_segments_data;
   ceph::msgr::v2::Tag next_tag;
+  __u8 next_frame_flags = 0;
   utime_t backoff;  // backoff time
   utime_t recv_stamp;
   utime_t throttle_stamp;
@@ -115,6 +117,22 @@ private:
   bool keepalive;
   bool write_in_progress = false;
 
+  // message frame compression; the policy is evaluated on the first
+  // message sent after the banner exchange
+  bool tx_compression_checked = false;
+  CompressorRef tx_compressor;
+  uint32_t tx_compression_min_size = 0;
+  std::array<CompressorRef, Compressor::COMP_ALG_LAST> rx_compressors;
+  // throttled for the current frame beyond get_current_msg_size(), once
+  // a compressed message turned out to be larger (or smaller) when raw
+  int64_t rx_throttle_delta = 0;
+
+  // write coalescing: while more messages are queued, hold back the
+  // socket write until cork_max_bytes or cork_max_latency is reached
+  uint64_t cork_max_bytes;
+  ceph::timespan cork_max_latency;
+  ceph::mono_time cork_start;
+
   ostream &_conn_prefix(std::ostream *_dout);
   void run_continuation(Ct<ProtocolV2> *pcontinuation);
   void run_continuation(Ct<ProtocolV2> &continuation);
@@ -137,8 +155,12 @@ private:
   void discard_out_queue();
   void reset_session();
   void prepare_send_message(uint64_t features, Message *m);
+  void init_tx_compression();
+  void adjust_rx_throttle(int64_t delta);
+  bool decompress_message_segments(size_t *msg_size);
   out_queue_entry_t _get_next_outgoing();
   ssize_t write_message(Message *m, bool more);
+  ssize_t flush_outgoing(bool more);
   void append_keepalive();
   void append_keepalive_ack(utime_t &timestamp);
   void handle_message_ack(uint64_t seq);
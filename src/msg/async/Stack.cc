@@ -19,6 +19,7 @@
 #include "include/compat.h"
 #include "common/Cond.h"
 #include "common/errno.h"
+#include "common/numa.h"
 #include "PosixStack.h"
 #ifdef HAVE_RDMA
 #include "rdma/RDMAStack.h"
@@ -41,6 +42,22 @@ std::function<void ()> NetworkStack::add_thread(unsigned worker_id)
       char tp_name[16];
       sprintf(tp_name, "msgr-worker-%u", w->id);
       ceph_pthread_setname(pthread_self(), tp_name);
+#ifdef HAVE_SCHED
+      if (w->id < worker_cpus.size()) {
+	cpu_set_t cpuset;
+	CPU_ZERO(&cpuset);
+	CPU_SET(worker_cpus[w->id], &cpuset);
+	int r = pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset);
+	if (r) {
+	  lderr(cct) << __func__ << " unable to pin worker " << w->id
+		     << " to cpu " << worker_cpus[w->id] << ": "
+		     << cpp_strerror(r) << dendl;
+	} else {
+	  ldout(cct, 10) << __func__ << " worker " << w->id << " pinned to cpu "
+			 << worker_cpus[w->id] << dendl;
+	}
+      }
+#endif
       const unsigned EventMaxWaitUs = 30000000;
       w->center.set_owner();
       ldout(cct, 10) << __func__ << " starting" << dendl;
@@ -107,6 +124,24 @@ NetworkStack::NetworkStack(CephContext *c, const string &t): type(t), started(fa
 
   const int InitEventNumber = 5000;
   num_workers = cct->_conf->ms_async_op_threads;
+
+  auto cores = cct->_conf.get_val<std::string>("ms_async_affinity_cores");
+  if (!cores.empty() && t != "dpdk") {  // dpdk places its own lcores
+    size_t cpu_set_size;
+    cpu_set_t cpu_set;
+    if (parse_cpu_set_list(cores.c_str(), &cpu_set_size, &cpu_set) < 0) {
+      lderr(cct) << __func__ << " unable to parse ms_async_affinity_cores '"
+		 << cores << "', ignoring" << dendl;
+    } else {
+      for (int cpu : cpu_set_to_set(cpu_set_size, &cpu_set)) {
+	worker_cpus.push_back(cpu);
+      }
+      if (!worker_cpus.empty()) {
+	num_workers = worker_cpus.size();
+	ldout(cct, 1) << __func__ << " one worker per cpu in " << cores << dendl;
+      }
+    }
+  }
   if (num_workers >= EventCenter::MAX_EVENTCENTER) {
     ldout(cct, 0) << __func__ << " max thread limit is "
                   << EventCenter::MAX_EVENTCENTER << ", switching to this now. "
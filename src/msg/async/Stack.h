@@ -29,6 +29,7 @@ class ConnectedSocketImpl {
   virtual int is_connected() = 0;
   virtual ssize_t read(char*, size_t) = 0;
   virtual ssize_t send(bufferlist &bl, bool more) = 0;
+  virtual void drain_error_queue() {}
   virtual void shutdown() = 0;
   virtual void close() = 0;
   virtual int fd() const = 0;
@@ -41,6 +42,8 @@ struct SocketOptions {
   int rcbuf_size = 0;
   int priority = -1;
   entity_addr_t connect_bind_addr;
+  bool reuseport = false;       ///< share the listening port via SO_REUSEPORT
+  bool reuseport_join = false;  ///< port is already ours; join its group
 };
 
 /// \cond internal
@@ -99,6 +102,13 @@ class ConnectedSocket {
   ssize_t send(bufferlist &bl, bool more) {
     return _csi->send(bl, more);
   }
+  /// Handles transmit completions queued on the socket.
+  ///
+  /// Must be called whenever the socket is reported readable, even if
+  /// the caller does not intend to read from it.
+  void drain_error_queue() {
+    _csi->drain_error_queue();
+  }
   /// Disables output to the socket.
   ///
   /// Current or future writes that have not been successfully flushed
@@ -203,6 +213,8 @@ enum {
   l_msgr_send_messages_queue_lat,
   l_msgr_handle_ack_lat,
 
+  l_msgr_send_calls,
+
   l_msgr_last,
 };
 
@@ -246,6 +258,8 @@ class Worker {
     plb.add_time_avg(l_msgr_send_messages_queue_lat, "msgr_send_messages_queue_lat", "Network sent messages lat");
     plb.add_time_avg(l_msgr_handle_ack_lat, "msgr_handle_ack_lat", "Connection handle ack lat");
 
+    plb.add_u64_counter(l_msgr_send_calls, "msgr_send_calls", "sendmsg() calls made by the posix stack (compare with msgr_send_messages)");
+
     perf_logger = plb.create_perf_counters();
     cct->get_perfcounters_collection()->add(perf_logger);
   }
@@ -303,6 +317,8 @@ class NetworkStack {
  protected:
   CephContext *cct;
   vector<Worker*> workers;
+  /// cpu each worker is pinned to, if ms_async_affinity_cores is set
+  vector<int> worker_cpus;
 
   explicit NetworkStack(CephContext *c, const string &t);
  public:
@@ -19,6 +19,14 @@ static constexpr const std::size_t AESGCM_IV_LEN{12};
 static constexpr const std::size_t AESGCM_TAG_LEN{16};
 static constexpr const std::size_t AESGCM_BLOCK_LEN{16};
 
+// plaintext buffers shorter than this are gathered into the ciphertext
+// buffer and encrypted in place, in as few EVP_EncryptUpdate() calls as
+// possible.  Frames are mostly made of many tiny encoded fragments and
+// OpenSSL's stitched AES-NI/CLMUL GCM kernel only engages on long runs;
+// calling it per fragment leaves most of the work to the slow path.
+static constexpr const std::size_t AESGCM_COALESCE_MAX{4096};
+static constexpr const std::size_t AESGCM_BATCH_MAX{64 * 1024};
+
 struct nonce_t {
   std::uint32_t random_seq;
   std::uint64_t random_rest;
@@ -38,6 +46,13 @@ class AES128GCM_OnWireTxHandler : public ceph::crypto::onwire::TxHandler {
   nonce_t nonce;
   static_assert(sizeof(nonce) == AESGCM_IV_LEN);
 
+  // plaintext already copied into "buffer", still to be encrypted in place
+  unsigned char* batch_begin = nullptr;
+  std::size_t batch_len = 0;
+
+  void encrypt(unsigned char* out, const unsigned char* in, std::size_t len);
+  void flush_batch();
+
 public:
   AES128GCM_OnWireTxHandler(CephContext* const cct,
 			    const key_t& key,
@@ -87,6 +102,32 @@ void AES128GCM_OnWireTxHandler::reset_tx_handler(
     std::end(update_size_sequence), AESGCM_TAG_LEN));
 
   ++nonce.random_seq;
+  batch_begin = nullptr;
+  batch_len = 0;
+}
+
+void AES128GCM_OnWireTxHandler::encrypt(
+  unsigned char* out,
+  const unsigned char* in,
+  std::size_t len)
+{
+  int update_len = 0;
+
+  if(1 != EVP_EncryptUpdate(ectx.get(), out, &update_len, in, len)) {
+    throw std::runtime_error("EVP_EncryptUpdate failed");
+  }
+  ceph_assert_always(update_len >= 0);
+  ceph_assert(static_cast<std::size_t>(update_len) == len);
+}
+
+void AES128GCM_OnWireTxHandler::flush_batch()
+{
+  if (batch_len) {
+    // GCM is CTR-based, so OpenSSL allows in == out
+    encrypt(batch_begin, batch_begin, batch_len);
+    batch_begin = nullptr;
+    batch_len = 0;
+  }
 }
 
 void AES128GCM_OnWireTxHandler::authenticated_encrypt_update(
@@ -95,18 +136,27 @@ void AES128GCM_OnWireTxHandler::authenticated_encrypt_update(
   auto filler = buffer.append_hole(plaintext.length());
 
   for (const auto& plainbuf : plaintext.buffers()) {
-    int update_len = 0;
+    auto* out = reinterpret_cast<unsigned char*>(filler.c_str());
+    const auto* in = reinterpret_cast<const unsigned char*>(plainbuf.c_str());
+    const std::size_t len = plainbuf.length();
 
-    if(1 != EVP_EncryptUpdate(ectx.get(),
-	reinterpret_cast<unsigned char*>(filler.c_str()),
-	&update_len,
-	reinterpret_cast<const unsigned char*>(plainbuf.c_str()),
-	plainbuf.length())) {
-      throw std::runtime_error("EVP_EncryptUpdate failed");
+    if (batch_len && batch_begin + batch_len != out) {
+      flush_batch();  // the ciphertext buffer isn't contiguous here
     }
-    ceph_assert_always(update_len >= 0);
-    ceph_assert(static_cast<unsigned>(update_len) == plainbuf.length());
-    filler.advance(update_len);
+    if (len >= AESGCM_COALESCE_MAX) {
+      flush_batch();
+      encrypt(out, in, len);
+    } else {
+      ::memcpy(out, in, len);
+      if (!batch_len) {
+	batch_begin = out;
+      }
+      batch_len += len;
+      if (batch_len >= AESGCM_BATCH_MAX) {
+	flush_batch();
+      }
+    }
+    filler.advance(len);
   }
 
   ldout(cct, 15) << __func__
@@ -117,6 +167,8 @@ void AES128GCM_OnWireTxHandler::authenticated_encrypt_update(
 
 ceph::bufferlist AES128GCM_OnWireTxHandler::authenticated_encrypt_final()
 {
+  flush_batch();
+
   int final_len = 0;
   auto filler = buffer.append_hole(AESGCM_BLOCK_LEN);
   if(1 != EVP_EncryptFinal_ex(ectx.get(),
@@ -3,6 +3,7 @@
 
 #include "include/types.h"
 #include "common/Clock.h"
+#include "compressor/Compressor.h"
 #include "crypto_onwire.h"
 #include <array>
 #include <utility>
@@ -99,7 +100,8 @@ struct preamble_block_t {
   __u8 num_segments;
 
   segment_t segments[MAX_NUM_SEGMENTS];
-  __u8 _reserved[2];
+  __u8 flags;  // FRAME_EARLY_FLAGS_*
+  __u8 _reserved;
 
   // CRC32 for this single preamble block.
   ceph_le32 crc;
@@ -150,6 +152,20 @@ static constexpr uint32_t FRAME_SECURE_EPILOGUE_SIZE =
 
 #define FRAME_FLAGS_LATEABRT      (1<<0)   /* frame was aborted after txing data */
 
+// preamble flags
+#define FRAME_EARLY_FLAGS_COMPRESSED (1<<0) /* non-empty segments but the first
+					       start with compression_header_t */
+
+// Prepended to every non-empty segment except the first of a frame with
+// FRAME_EARLY_FLAGS_COMPRESSED.  Segments that didn't compress well are
+// carried as they are, with algorithm set to COMP_ALG_NONE.  Only message
+// frames get compressed, and only to peers with CEPH_MSGR2_FEATURE_COMPRESSION.
+struct compression_header_t {
+  ceph_le32 raw_length;
+  __u8 algorithm;  // Compressor::CompressionAlgorithm
+} __attribute__((packed));
+static_assert(std::is_standard_layout<compression_header_t>::value);
+
 static uint32_t segment_onwire_size(const uint32_t logical_size)
 {
   return p2roundup<uint32_t>(logical_size, CRYPTO_BLOCK_SIZE);
@@ -177,6 +193,10 @@ private:
   };
   ceph::bufferlist::contiguous_filler preamble_filler;
 
+protected:
+  __u8 early_flags = 0;
+
+private:
   __u8 calc_num_segments(const segment_t segments[])
   {
     for (__u8 num = SegmentsNumV; num > 0; num--) {
@@ -199,6 +219,7 @@ private:
 
     main_preamble.tag = static_cast<__u8>(T::tag);
     ceph_assert(main_preamble.tag != 0);
+    main_preamble.flags = early_flags;
 
     // implementation detail: the first bufferlist of Frame::segments carries
     // space for preamble. This glueing isn't a part of the onwire format but
@@ -705,9 +726,141 @@ struct MessageFrame : public Frame<MessageFrame,
     return f;
   }
 
+  // Compress the front, middle and data segments that are at least
+  // min_size long.  The header segment, which also carries the preamble,
+  // is left alone.  Returns false, leaving the frame untouched, if the
+  // peer (by the features from its banner) can't take compressed frames
+  // or if nothing got smaller.
+  bool compress(Compressor &compressor, uint32_t min_size,
+                uint64_t peer_supported_features) {
+    if (!HAVE_MSGR2_FEATURE(peer_supported_features, COMPRESSION)) {
+      return false;
+    }
+    std::array<ceph::bufferlist, SegmentsNumV> compressed;
+    bool any = false;
+    for (__u8 idx = SegmentIndex::Msg::FRONT; idx < SegmentsNumV; idx++) {
+      const auto& segment = segments[idx];
+      if (!segment.length() || segment.length() < min_size) {
+        continue;
+      }
+      ceph::bufferlist out;
+      if (compressor.compress(segment, out) == 0 &&
+          out.length() + sizeof(compression_header_t) < segment.length()) {
+        compressed[idx] = std::move(out);
+        any = true;
+      }
+    }
+    if (!any) {
+      return false;
+    }
+
+    for (__u8 idx = SegmentIndex::Msg::FRONT; idx < SegmentsNumV; idx++) {
+      auto& segment = segments[idx];
+      if (!segment.length()) {
+        continue;
+      }
+      compression_header_t header;
+      header.raw_length = segment.length();
+      header.algorithm = compressed[idx].length() ?
+        compressor.get_type() : Compressor::COMP_ALG_NONE;
+
+      ceph::bufferlist bl;
+      bl.append(reinterpret_cast<const char*>(&header), sizeof(header));
+      bl.claim_append(compressed[idx].length() ? compressed[idx] : segment);
+      segment = std::move(bl);
+    }
+    early_flags |= FRAME_EARLY_FLAGS_COMPRESSED;
+    return true;
+  }
+
   using rx_segments_t =
     boost::container::static_vector<ceph::bufferlist,
                                     ceph::msgr::v2::MAX_NUM_SEGMENTS>;
+
+  // For a frame with FRAME_EARLY_FLAGS_COMPRESSED: the length of the
+  // front, middle and data segments once decompressed.  Only the
+  // compression headers are looked at, so the receiver can check the
+  // size and account for it before inflating anything.  Returns -EINVAL
+  // for a malformed header and -EMSGSIZE if the total exceeds max_length.
+  static int64_t get_decompressed_length(const rx_segments_t &segments,
+                                         uint64_t max_length) {
+    uint64_t total = 0;
+    for (__u8 idx = SegmentIndex::Msg::FRONT; idx < std::size(segments);
+         idx++) {
+      const auto& segment = segments[idx];
+      if (!segment.length()) {
+        continue;
+      }
+      compression_header_t header;
+      if (segment.length() < sizeof(header)) {
+        return -EINVAL;
+      }
+      segment.begin().copy(sizeof(header), reinterpret_cast<char*>(&header));
+      if (header.algorithm >= Compressor::COMP_ALG_LAST) {
+        return -EINVAL;
+      }
+      total += header.raw_length;
+    }
+    if (total > max_length) {
+      return -EMSGSIZE;
+    }
+    return total;
+  }
+
+  // Replace the front, middle and data segments of a compressed frame
+  // with their decompressed contents.  Compressors are created on first
+  // use and kept in "compressors".  Fails with -EINVAL if a segment
+  // doesn't decompress to the length its header promises.
+  static int decompress(
+    CephContext *cct, rx_segments_t &segments,
+    std::array<CompressorRef, Compressor::COMP_ALG_LAST> &compressors) {
+    for (__u8 idx = SegmentIndex::Msg::FRONT; idx < std::size(segments);
+         idx++) {
+      auto& segment = segments[idx];
+      if (!segment.length()) {
+        continue;
+      }
+      compression_header_t header;
+      if (segment.length() < sizeof(header)) {
+        return -EINVAL;
+      }
+      segment.begin().copy(sizeof(header), reinterpret_cast<char*>(&header));
+      ceph::bufferlist payload;
+      segment.splice(sizeof(header), segment.length() - sizeof(header),
+                     &payload);
+
+      ceph::bufferlist raw;
+      if (header.algorithm == Compressor::COMP_ALG_NONE) {
+        raw = std::move(payload);
+      } else {
+        if (header.algorithm >= Compressor::COMP_ALG_LAST) {
+          return -EINVAL;
+        }
+        auto& compressor = compressors[header.algorithm];
+        if (!compressor) {
+          compressor = Compressor::create(cct, header.algorithm);
+          if (!compressor) {
+            return -ENOENT;
+          }
+        }
+        int r;
+        try {
+          r = compressor->decompress(payload, raw);
+        } catch (const ceph::buffer::error &e) {
+          r = -EIO;
+        }
+        if (r < 0) {
+          return r;
+        }
+      }
+      if (raw.length() != header.raw_length) {
+        return -EINVAL;
+      }
+      segment = std::move(raw);
+    }
+    return 0;
+  }
+
   static MessageFrame Decode(rx_segments_t &&recv_segments) {
     MessageFrame f;
     // transfer segments' bufferlists. If a MessageFrame contains less
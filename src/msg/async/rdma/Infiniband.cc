@@ -26,7 +26,6 @@
 #define dout_prefix *_dout << "Infiniband "
 
 static const uint32_t MAX_SHARED_RX_SGE_COUNT = 1;
-static const uint32_t MAX_INLINE_DATA = 0;
 static const uint32_t TCP_MSG_LEN = sizeof("0000:00000000:00000000:00000000:00000000000000000000000000000000");
 static const uint32_t CQ_DEPTH = 30000;
 
@@ -321,14 +320,41 @@ int Infiniband::QueuePair::init()
     qpia.cap.max_recv_wr = max_recv_wr;
     qpia.cap.max_recv_sge = 1;
   }
-  qpia.cap.max_send_wr  = max_send_wr; // max outstanding send requests
+  // small sends are copied into the WQE by the HCA (IBV_SEND_INLINE) and
+  // don't hold a tx chunk, so give them their own send queue slots
+  uint32_t inline_data = std::min<uint64_t>(
+    cct->_conf.get_val<uint64_t>("ms_async_rdma_max_inline_data"),
+    MAX_INLINE_DATA);
+  uint32_t inline_wr = 0;
+  if (inline_data) {
+    uint32_t max_qp_wr = infiniband.device->device_attr.max_qp_wr;
+    if (max_qp_wr > max_send_wr)
+      inline_wr = std::min<uint32_t>(MAX_INLINE_SEND_WR, max_qp_wr - max_send_wr);
+    if (!inline_wr)
+      inline_data = 0;
+  }
+  qpia.cap.max_send_wr  = max_send_wr + inline_wr; // max outstanding send requests
   qpia.cap.max_send_sge = 1;           // max send scatter-gather elements
-  qpia.cap.max_inline_data = MAX_INLINE_DATA;          // max bytes of immediate data on send q
+  qpia.cap.max_inline_data = inline_data; // max bytes of immediate data on send q
   qpia.qp_type = type;                 // RC, UC, UD, or XRC
   qpia.sq_sig_all = 0;                 // only generate CQEs on requested WQEs
 
+  auto disable_inline = [&]() {
+    if (!qpia.cap.max_inline_data)
+      return false;
+    ldout(cct, 1) << __func__ << " unable to create queue pair with "
+                  << qpia.cap.max_inline_data << " bytes of inline data ("
+                  << cpp_strerror(errno) << "), retrying without" << dendl;
+    qpia.cap.max_send_wr = max_send_wr;
+    qpia.cap.max_inline_data = inline_data = 0;
+    inline_wr = 0;
+    return true;
+  };
+
   if (!cct->_conf->ms_async_rdma_cm) {
     qp = ibv_create_qp(pd, &qpia);
+    if (qp == NULL && disable_inline())
+      qp = ibv_create_qp(pd, &qpia);
     if (qp == NULL) {
       lderr(cct) << __func__ << " failed to create queue pair" << cpp_strerror(errno) << dendl;
       if (errno == ENOMEM) {
@@ -344,15 +370,23 @@ int Infiniband::QueuePair::init()
     }
   } else {
     ceph_assert(cm_id->verbs == pd->context);
-    if (rdma_create_qp(cm_id, pd, &qpia)) {
+    int r = rdma_create_qp(cm_id, pd, &qpia);
+    if (r && disable_inline())
+      r = rdma_create_qp(cm_id, pd, &qpia);
+    if (r) {
       lderr(cct) << __func__ << " failed to create queue pair with rdmacm library"
                  << cpp_strerror(errno) << dendl;
       return -1;
     }
     qp = cm_id->qp;
   }
+  // the verbs provider reports back what it actually allocated
+  max_inline_data = std::min(qpia.cap.max_inline_data, inline_data);
+  inline_send_wr = max_inline_data ? inline_wr : 0;
+  inline_credits = inline_send_wr;
   ldout(cct, 20) << __func__ << " successfully create queue pair: "
-                 << "qp=" << qp << dendl;
+                 << "qp=" << qp << " max_inline_data=" << max_inline_data
+                 << dendl;
   local_cm_meta.local_qpn = get_local_qp_number();
   local_cm_meta.psn = get_initial_psn();
   local_cm_meta.lid = infiniband.get_lid();
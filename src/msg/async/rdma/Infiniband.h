@@ -47,6 +47,12 @@
 #define PSN_MSK ((1 << PSN_LEN) - 1)
 
 #define BEACON_WRID 0xDEADBEEF
+// low bit of the wr_id of inline sends, which carry the QueuePair pointer
+#define INLINE_WRID_FLAG 0x1
+// upper bound on ms_async_rdma_max_inline_data
+#define MAX_INLINE_DATA 1024
+// send queue slots reserved for inline sends on top of the tx chunks
+#define MAX_INLINE_SEND_WR 64
 
 struct ib_cm_meta_t {
   uint16_t lid;
@@ -182,6 +188,7 @@ enum {
   l_msgr_rdma_tx_failed,
 
   l_msgr_rdma_tx_chunks,
+  l_msgr_rdma_tx_inline,
   l_msgr_rdma_tx_bytes,
   l_msgr_rdma_rx_chunks,
   l_msgr_rdma_rx_bytes,
@@ -529,6 +536,33 @@ class Infiniband {
       recv_queue.erase(it);
     }
     ibv_srq* get_srq() const { return srq; }
+    /**
+     * Largest payload that may be posted with IBV_SEND_INLINE, 0 if the
+     * QueuePair was created without inline data support.
+     */
+    uint32_t get_max_inline_data() const { return max_inline_data; }
+    /**
+     * Take one of the send queue slots reserved for inline sends.
+     *
+     * Inline sends are posted unsignaled, except for the one that uses
+     * up the last slot: it requests a completion (*signaled), and since
+     * a QP completes its sends in order, that completion frees the slots
+     * of all the inline sends before it.  So each QP has at most one
+     * inline completion outstanding on the shared tx CQ, like its beacon.
+     */
+    bool get_inline_credit(bool *signaled) {
+      uint32_t c = inline_credits;
+      while (c && !inline_credits.compare_exchange_weak(c, c - 1))
+        ;
+      if (!c)
+        return false;
+      *signaled = c == 1;
+      return true;
+    }
+    /// give back a slot taken for a send that could not be posted
+    void put_inline_credit() { ++inline_credits; }
+    /// a signaled inline send completed: all inline slots are free again
+    void inline_sends_completed() { inline_credits = inline_send_wr; }
 
    private:
     CephContext  *cct;
@@ -548,6 +582,9 @@ class Infiniband {
     uint32_t     max_send_wr;
     uint32_t     max_recv_wr;
     uint32_t     q_key;
+    uint32_t     max_inline_data = 0;
+    uint32_t     inline_send_wr = 0;
+    std::atomic<uint32_t> inline_credits = {0};
     bool dead;
     vector<Chunk*> recv_queue;
     ceph::mutex lock = ceph::make_mutex("queue_pair_lock");
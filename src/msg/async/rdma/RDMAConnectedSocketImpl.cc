@@ -349,6 +349,10 @@ ssize_t RDMAConnectedSocketImpl::submit(bool more)
   if (!bytes)
     return 0;
 
+  bool signaled;
+  if (bytes <= qp->get_max_inline_data() && qp->get_inline_credit(&signaled))
+    return post_inline_request(signaled);
+
   std::vector<Chunk*> tx_buffers;
   auto it = std::cbegin(pending_bl.buffers());
   auto copy_start = it;
@@ -449,6 +453,50 @@ int RDMAConnectedSocketImpl::post_work_request(std::vector<Chunk*> &tx_buffers)
   return 0;
 }
 
+int RDMAConnectedSocketImpl::post_inline_request(bool signaled)
+{
+  // The HCA copies inline data into the WQE when it is posted, so small
+  // payloads go out without a registered tx chunk.
+  char buf[MAX_INLINE_DATA];
+  uint32_t len = pending_bl.length();
+  ibv_sge isge;
+  isge.addr = reinterpret_cast<uint64_t>(buf);
+  isge.length = len;
+  isge.lkey = 0;  // not used for inline data
+  if (pending_bl.get_num_buffers() == 1) {
+    isge.addr = reinterpret_cast<uint64_t>(pending_bl.front().c_str());
+  } else {
+    pending_bl.begin().copy(len, buf);
+  }
+
+  ibv_send_wr iswr;
+  // FIPS zeroization audit 20191115: this memset is not security related.
+  memset(&iswr, 0, sizeof(iswr));
+  iswr.wr_id = reinterpret_cast<uint64_t>(qp) | INLINE_WRID_FLAG;
+  iswr.sg_list = &isge;
+  iswr.num_sge = 1;
+  iswr.opcode = IBV_WR_SEND;
+  // unsignaled sends still complete with an error if the QP is flushed,
+  // so they carry the tagged wr_id too
+  iswr.send_flags = IBV_SEND_INLINE | (signaled ? IBV_SEND_SIGNALED : 0);
+
+  ldout(cct, 25) << __func__ << " QP: " << local_qpn << " inline " << len
+                 << " bytes" << dendl;
+  ibv_send_wr *bad_tx_work_request = nullptr;
+  if (ibv_post_send(qp->get_qp(), &iswr, &bad_tx_work_request)) {
+    ldout(cct, 1) << __func__ << " failed to send data"
+                  << " (most probably should be peer not ready): "
+                  << cpp_strerror(errno) << dendl;
+    qp->put_inline_credit();
+    worker->perf_logger->inc(l_msgr_rdma_tx_failed);
+    return -errno;
+  }
+  pending_bl.clear();
+  worker->perf_logger->inc(l_msgr_rdma_tx_inline);
+  worker->perf_logger->inc(l_msgr_rdma_tx_bytes, len);
+  return 0;
+}
+
 void RDMAConnectedSocketImpl::fin() {
   ibv_send_wr wr;
   // FIPS zeroization audit 20191115: this memset is not security related.
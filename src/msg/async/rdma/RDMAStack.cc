@@ -535,6 +535,16 @@ void RDMADispatcher::handle_tx_event(ibv_wc *cqe, int n)
       }
     }
 
+    // inline sends don't use a chunk; only the last of a run is signaled,
+    // and its completion frees the send queue slots of the whole run
+    if (response->wr_id & INLINE_WRID_FLAG) {
+      if (response->status == IBV_WC_SUCCESS) {
+        auto qp = reinterpret_cast<QueuePair*>(response->wr_id & ~INLINE_WRID_FLAG);
+        qp->inline_sends_completed();
+      }
+      continue;
+    }
+
     auto chunk = reinterpret_cast<Chunk *>(response->wr_id);
     //TX completion may come either from
     // 1) regular send message, WCE wr_id points to chunk
@@ -664,6 +674,7 @@ RDMAWorker::RDMAWorker(CephContext *c, unsigned worker_id)
   plb.add_u64_counter(l_msgr_rdma_tx_failed, "tx_failed_post", "The number of tx failed posted");
 
   plb.add_u64_counter(l_msgr_rdma_tx_chunks, "tx_chunks", "The number of tx chunks transmitted");
+  plb.add_u64_counter(l_msgr_rdma_tx_inline, "tx_inline", "The number of small sends posted inline, without a tx chunk");
   plb.add_u64_counter(l_msgr_rdma_tx_bytes, "tx_bytes", "The bytes of tx chunks transmitted", NULL, 0, unit_t(UNIT_BYTES));
   plb.add_u64_counter(l_msgr_rdma_rx_chunks, "rx_chunks", "The number of rx chunks transmitted");
   plb.add_u64_counter(l_msgr_rdma_rx_bytes, "rx_bytes", "The bytes of rx chunks transmitted", NULL, 0, unit_t(UNIT_BYTES));
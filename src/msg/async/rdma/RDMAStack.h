@@ -198,6 +198,7 @@ class RDMAConnectedSocketImpl : public ConnectedSocketImpl {
   void buffer_prefetch(void);
   ssize_t read_buffers(char* buf, size_t len);
   int post_work_request(std::vector<Chunk*>&);
+  int post_inline_request(bool signaled);
   size_t tx_copy_chunk(std::vector<Chunk*> &tx_buffers, size_t req_copy_len,
       decltype(std::cbegin(pending_bl.buffers()))& start,
       const decltype(std::cbegin(pending_bl.buffers()))& end);
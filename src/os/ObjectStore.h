@@ -541,6 +541,32 @@ public:
      return total;
    }
 
+  /**
+   * verify_csums -- verify the stored checksums of a byte range of an
+   * object without returning (or decompressing) its data
+   *
+   * For backends which keep their own data checksums: bit rot can be
+   * detected without shipping the object contents up to the OSD.  No
+   * digest comparable across replicas is produced.
+   *
+   * @param cid collection for object
+   * @param oid oid of object
+   * @param offset location offset of first byte to be verified
+   * @param len number of bytes to be verified
+   * @param op_flags is CEPH_OSD_OP_FLAG_*
+   * @returns number of bytes covered on success, -EIO on checksum mismatch,
+   *          -EOPNOTSUPP if the backend does not keep data checksums, or
+   *          another negative error code on failure.
+   */
+  virtual int verify_csums(
+    CollectionHandle &c,
+    const ghobject_t& oid,
+    uint64_t offset,
+    size_t len,
+    uint32_t op_flags = 0) {
+    return -EOPNOTSUPP;
+  }
+
   /**
    * dump_onode -- dumps onode metadata in human readable form,
      intended primiarily for debugging
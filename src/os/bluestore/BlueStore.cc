@@ -9857,6 +9857,135 @@ int BlueStore::_do_read(
   return r;
 }
 
+int BlueStore::verify_csums(
+  CollectionHandle &c_,
+  const ghobject_t& oid,
+  uint64_t offset,
+  size_t length,
+  uint32_t op_flags)
+{
+  Collection *c = static_cast<Collection *>(c_.get());
+  const coll_t &cid = c->get_cid();
+  dout(15) << __func__ << " " << cid << " " << oid
+	   << " 0x" << std::hex << offset << "~" << length << std::dec
+	   << dendl;
+  if (!c->exists)
+    return -ENOENT;
+
+  int r;
+  {
+    std::shared_lock l(c->lock);
+    OnodeRef o = c->get_onode(oid, false);
+    if (!o || !o->exists) {
+      r = -ENOENT;
+      goto out;
+    }
+    r = _do_verify_csums(c, o, offset, length);
+    if (r == -EIO) {
+      logger->inc(l_bluestore_read_eio);
+    }
+  }
+
+ out:
+  if (r >= 0 && _debug_data_eio(oid)) {
+    r = -EIO;
+    derr << __func__ << " " << c->cid << " " << oid << " INJECT EIO" << dendl;
+  }
+  dout(10) << __func__ << " " << cid << " " << oid
+	   << " 0x" << std::hex << offset << "~" << length << std::dec
+	   << " = " << r << dendl;
+  return r;
+}
+
+int BlueStore::_do_verify_csums(
+  Collection *c,
+  OnodeRef o,
+  uint64_t offset,
+  size_t length,
+  uint64_t retry_count)
+{
+  dout(20) << __func__ << " 0x" << std::hex << offset << "~" << length
+           << " size 0x" << o->onode.size << " (" << std::dec
+           << o->onode.size << ")" << dendl;
+  if (offset >= o->onode.size) {
+    return 0;
+  }
+  if (offset + length > o->onode.size) {
+    length = o->onode.size - offset;
+  }
+  o->extent_map.fault_range(db, offset, length);
+
+  // only dirty buffers may come from the cache; everything else is read
+  // from the device so that silent media errors are caught.
+  ready_regions_t ready_regions;
+  blobs2read_t blobs2read;
+  _read_cache(o, offset, length, BufferSpace::BYPASS_CLEAN_CACHE,
+              ready_regions, blobs2read);
+  for (auto& p : blobs2read) {
+    if (!p.first->get_blob().has_csum()) {
+      dout(20) << __func__ << "  blob " << *p.first << " has no csum" << dendl;
+      return -EOPNOTSUPP;
+    }
+  }
+
+  vector<bufferlist> compressed_blob_bls;
+  IOContext ioc(cct, NULL, true); // allow EIO
+  int r = _prepare_read_ioc(blobs2read, &compressed_blob_bls, &ioc);
+  if (r < 0)
+    return r;
+  if (ioc.has_pending_aios()) {
+    bdev->aio_submit(&ioc);
+    dout(20) << __func__ << " waiting for aio" << dendl;
+    ioc.aio_wait();
+    r = ioc.get_return_value();
+    if (r < 0) {
+      ceph_assert(r == -EIO); // no other errors allowed
+      return -EIO;
+    }
+  }
+
+  // compressed blobs are verified in their on-disk form and are never
+  // decompressed; nothing is assembled into a result buffer.
+  bool csum_error = false;
+  auto cp = compressed_blob_bls.begin();
+  for (auto& p : blobs2read) {
+    const BlobRef& bptr = p.first;
+    regions2read_t& r2r = p.second;
+    if (bptr->get_blob().is_compressed()) {
+      ceph_assert(cp != compressed_blob_bls.end());
+      if (_verify_csum(o, &bptr->get_blob(), 0, *cp++,
+                       r2r.front().regs.front().logical_offset) < 0) {
+        csum_error = true;
+      }
+    } else {
+      for (auto& req : r2r) {
+        if (_verify_csum(o, &bptr->get_blob(), req.r_off, req.bl,
+                         req.regs.front().logical_offset) < 0) {
+          csum_error = true;
+          break;
+        }
+      }
+    }
+    if (csum_error) {
+      break;
+    }
+  }
+  if (csum_error) {
+    // see _do_read() for why a failed verification is retried
+    if (retry_count >= cct->_conf->bluestore_retry_disk_reads) {
+      return -EIO;
+    }
+    return _do_verify_csums(c, o, offset, length, retry_count + 1);
+  }
+  if (retry_count) {
+    logger->inc(l_bluestore_reads_with_retries);
+    dout(5) << __func__ << " verify at 0x" << std::hex << offset << "~"
+            << length << " failed " << std::dec << retry_count
+            << " times before succeeding" << dendl;
+  }
+  return length;
+}
+
 int BlueStore::_verify_csum(OnodeRef& o,
 			    const bluestore_blob_t* blob, uint64_t blob_xoffset,
 			    const bufferlist& bl,
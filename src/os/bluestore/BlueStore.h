@@ -2596,6 +2596,12 @@ public:
     size_t len,
     bufferlist& bl,
     uint32_t op_flags = 0) override;
+  int verify_csums(
+    CollectionHandle &c,
+    const ghobject_t& oid,
+    uint64_t offset,
+    size_t len,
+    uint32_t op_flags = 0) override;
 
 private:
 
@@ -2688,6 +2694,13 @@ private:
     uint32_t op_flags = 0,
     uint64_t retry_count = 0);
 
+  int _do_verify_csums(
+    Collection *c,
+    OnodeRef o,
+    uint64_t offset,
+    size_t len,
+    uint64_t retry_count = 0);
+
   int _fiemap(CollectionHandle &c_, const ghobject_t& oid,
  	     uint64_t offset, size_t len, interval_set<uint64_t>& destset);
 public:
@@ -0,0 +1,93 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+/*
+ * Ceph - scalable distributed file system
+ *
+ * This is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License version 2.1, as published by the Free Software
+ * Foundation.  See file COPYING.
+ *
+ */
+
+#ifndef CEPH_OSD_HEARTBEATCREDIT_H
+#define CEPH_OSD_HEARTBEATCREDIT_H
+
+#include <set>
+
+#include "include/utime.h"
+
+/**
+ * Decides when the back (cluster network) ping to a heartbeat peer can be
+ * skipped because of cluster traffic (osd_heartbeat_piggyback).
+ *
+ * Traffic from the peer alone only shows that the peer -> us direction
+ * works, while the peer's failure reports about us still depend on it
+ * hearing from us.  So only replies to our own requests count (see
+ * note_ack()): they show that the peer received something we sent on the
+ * cluster network and that its answer made it back.
+ *
+ * A credited round has no back round trip, so it must not produce a back
+ * ping time sample; was_credited() lets the reply path tell them apart.
+ * At most MAX_CONSECUTIVE rounds are credited in a row so the back ping
+ * times keep being refreshed from real pings.
+ */
+class HeartbeatCredit {
+public:
+  static constexpr unsigned MAX_CONSECUTIVE = 3;
+
+private:
+  utime_t last_ack;            ///< last time the peer acknowledged our traffic
+  unsigned consecutive = 0;    ///< rounds credited since the last real back ping
+  std::set<utime_t> credited;  ///< ping stamps of credited rounds in flight
+
+public:
+  /// the peer replied to a request we sent it on the cluster messenger
+  void note_ack(utime_t now) {
+    if (now > last_ack)
+      last_ack = now;
+  }
+  utime_t get_last_ack() const {
+    return last_ack;
+  }
+
+  /**
+   * Whether the back ping of the round about to be sent can be skipped.
+   *
+   * @param last_tx       when the previous round was sent
+   * @param last_rx_back  last real (or credited) back reply
+   * @param have_front    whether the peer has a front connection; without
+   *                      one the back ping is the only probe, so keep it
+   */
+  bool can_credit(utime_t last_tx, utime_t last_rx_back,
+		  bool have_front) const {
+    return have_front &&
+      last_rx_back != utime_t() &&
+      consecutive < MAX_CONSECUTIVE &&
+      last_ack > last_tx;
+  }
+
+  /// record the round's outcome: credited or a real back ping was sent
+  void sent(utime_t ping_stamp, bool credit) {
+    if (credit) {
+      credited.insert(ping_stamp);
+      ++consecutive;
+    } else {
+      consecutive = 0;
+    }
+  }
+
+  /**
+   * Whether the round sent at @p ping_stamp was credited.  Called once all
+   * replies for that round are in, which also retires older rounds, so
+   * forget those as well.
+   */
+  bool was_credited(utime_t ping_stamp) {
+    auto p = credited.upper_bound(ping_stamp);
+    bool r = p != credited.begin() && *std::prev(p) == ping_stamp;
+    credited.erase(credited.begin(), p);
+    return r;
+  }
+};
+
+#endif
@@ -5390,13 +5390,20 @@ void OSD::handle_osd_ping(MOSDPing *m)
 
 #define ROUND_S_TO_USEC(sec) (uint32_t)((sec) * 1000 * 1000 + 0.5)
 	    ++i->second.hb_average_count;
-	    uint32_t back_pingtime = ROUND_S_TO_USEC(i->second.last_rx_back - m->ping_stamp);
-	    i->second.hb_total_back += back_pingtime;
-	    if (back_pingtime < i->second.hb_min_back)
-	      i->second.hb_min_back = back_pingtime;
-	    if (back_pingtime > i->second.hb_max_back)
-	      i->second.hb_max_back = back_pingtime;
 	    uint32_t front_pingtime = ROUND_S_TO_USEC(i->second.last_rx_front - m->ping_stamp);
+	    // a back ping credited from cluster traffic (osd_heartbeat_piggyback)
+	    // has no round trip of its own, so it adds no back sample
+	    if (!i->second.back_credit.was_credited(m->ping_stamp)) {
+	      uint32_t back_pingtime = ROUND_S_TO_USEC(i->second.last_rx_back - m->ping_stamp);
+	      ++i->second.hb_back_count;
+	      i->second.hb_back_last = back_pingtime;
+	      i->second.hb_total_back += back_pingtime;
+	      if (back_pingtime < i->second.hb_min_back)
+	        i->second.hb_min_back = back_pingtime;
+	      if (back_pingtime > i->second.hb_max_back)
+	        i->second.hb_max_back = back_pingtime;
+	    }
+	    uint32_t back_pingtime = i->second.hb_back_last;
 	    i->second.hb_total_front += front_pingtime;
 	    if (front_pingtime < i->second.hb_min_front)
 	      i->second.hb_min_front = front_pingtime;
@@ -5410,8 +5417,10 @@ void OSD::handle_osd_ping(MOSDPing *m)
 	    if (cct->_conf.get_val<int64_t>("debug_heartbeat_testing_span")) {
 	      hb_avg_time_period = cct->_conf.get_val<int64_t>("debug_heartbeat_testing_span");
 	    }
-	    if (now - i->second.hb_interval_start >=  utime_t(hb_avg_time_period, 0)) {
-              uint32_t back_avg = i->second.hb_total_back / i->second.hb_average_count;
+	    // an interval ends only once it has a real back sample as well
+	    if (now - i->second.hb_interval_start >=  utime_t(hb_avg_time_period, 0) &&
+		i->second.hb_back_count > 0) {
+              uint32_t back_avg = i->second.hb_total_back / i->second.hb_back_count;
               uint32_t back_min = i->second.hb_min_back;
               uint32_t back_max = i->second.hb_max_back;
               uint32_t front_avg = i->second.hb_total_front / i->second.hb_average_count;
@@ -5420,6 +5429,7 @@ void OSD::handle_osd_ping(MOSDPing *m)
 
 	      // Reset for new interval
 	      i->second.hb_average_count = 0;
+	      i->second.hb_back_count = 0;
 	      i->second.hb_interval_start = now;
 	      i->second.hb_total_back = i->second.hb_max_back = 0;
 	      i->second.hb_min_back =  UINT_MAX;
@@ -5696,11 +5706,20 @@ void OSD::heartbeat()
     int peer = i->first;
     dout(30) << "heartbeat sending ping to osd." << peer << dendl;
 
+    // If the peer acknowledged our cluster traffic since the last round,
+    // that vouches for the back side in both directions; only ping the
+    // front.  See HeartbeatCredit for when this is allowed.
+    bool piggyback = cct->_conf->osd_heartbeat_piggyback &&
+      i->second.back_credit.can_credit(i->second.last_tx,
+				       i->second.last_rx_back,
+				       i->second.con_front != nullptr);
+
     i->second.last_tx = now;
     if (i->second.first_tx == utime_t())
       i->second.first_tx = now;
     i->second.ping_history[now] = make_pair(deadline,
-      HeartbeatInfo::HEARTBEAT_MAX_CONN);
+      HeartbeatInfo::HEARTBEAT_MAX_CONN - (piggyback ? 1 : 0));
+    i->second.back_credit.sent(now, piggyback);
     if (i->second.hb_interval_start == utime_t())
       i->second.hb_interval_start = now;
 
@@ -5708,16 +5727,25 @@ void OSD::heartbeat()
     std::optional<ceph::signedspan> delta_ub;
     s->stamps->sent_ping(&delta_ub);
 
-    i->second.con_back->send_message(
-      new MOSDPing(monc->get_fsid(),
-		   service.get_osdmap_epoch(),
-		   MOSDPing::PING,
-		   now,
-		   mnow,
-		   mnow,
-		   service.get_up_epoch(),
-		   cct->_conf->osd_heartbeat_min_size,
-		   delta_ub));
+    if (piggyback) {
+      dout(30) << "heartbeat crediting back ping to osd." << peer
+	       << " from cluster reply at " << i->second.back_credit.get_last_ack()
+	       << dendl;
+      i->second.last_rx_back = std::max(i->second.last_rx_back,
+					i->second.back_credit.get_last_ack());
+      logger->inc(l_osd_hb_piggyback);
+    } else {
+      i->second.con_back->send_message(
+	new MOSDPing(monc->get_fsid(),
+		     service.get_osdmap_epoch(),
+		     MOSDPing::PING,
+		     now,
+		     mnow,
+		     mnow,
+		     service.get_up_epoch(),
+		     cct->_conf->osd_heartbeat_min_size,
+		     delta_ub));
+    }
 
     if (i->second.con_front)
       i->second.con_front->send_message(
@@ -5747,6 +5775,41 @@ void OSD::heartbeat()
   dout(30) << "heartbeat done" << dendl;
 }
 
+void OSD::note_peer_traffic(Message *m)
+{
+  // Only replies to requests we sent show that the peer hears us on the
+  // cluster network; anything else proves just one direction.
+  switch (m->get_type()) {
+  case MSG_OSD_REPOPREPLY:
+  case MSG_OSD_EC_WRITE_REPLY:
+  case MSG_OSD_EC_READ_REPLY:
+  case MSG_OSD_PG_PUSH_REPLY:
+  case MSG_OSD_PG_UPDATE_LOG_MISSING_REPLY:
+    break;
+  default:
+    return;
+  }
+  // Called for every such reply, so only take heartbeat_lock about twice
+  // per heartbeat interval per session.
+  auto s = ceph::ref_cast<Session>(m->get_connection()->get_priv());
+  if (!s) {
+    return;
+  }
+  auto mnow = ceph::mono_clock::now();
+  auto credit_interval = std::chrono::milliseconds(
+    cct->_conf->osd_heartbeat_interval * 500);
+  auto last = s->last_hb_credit.load();
+  if (mnow - last < credit_interval ||
+      !s->last_hb_credit.compare_exchange_strong(last, mnow)) {
+    return;
+  }
+  std::lock_guard l(heartbeat_lock);
+  auto p = heartbeat_peers.find(m->get_source().num());
+  if (p != heartbeat_peers.end()) {
+    p->second.back_credit.note_ack(ceph_clock_now());
+  }
+}
+
 bool OSD::heartbeat_reset(Connection *con)
 {
   std::lock_guard l(heartbeat_lock);
@@ -7057,6 +7120,12 @@ void OSD::ms_fast_dispatch(Message *m)
     }
   }
 
+  if (cct->_conf->osd_heartbeat_piggyback &&
+      m->get_source().is_osd() &&
+      m->get_connection()->get_messenger() == cluster_messenger) {
+    note_peer_traffic(m);
+  }
+
   OpRequestRef op = op_tracker.create_request<OpRequest, Message*>(m);
   {
 #ifdef WITH_LTTNG
@@ -35,6 +35,7 @@
 #include "auth/KeyRing.h"
 
 #include "osd/ClassHandler.h"
+#include "osd/HeartbeatCredit.h"
 
 #include "include/CompatSet.h"
 
@@ -1386,6 +1387,7 @@ private:
     utime_t last_tx;    ///< last time we sent a ping request
     utime_t last_rx_front;  ///< last time we got a ping reply on the front side
     utime_t last_rx_back;   ///< last time we got a ping reply on the back side
+    HeartbeatCredit back_credit; ///< back pings skipped for cluster traffic
     epoch_t epoch;      ///< most recent epoch we wanted this peer
     /// number of connections we send and receive heartbeat pings/replies
     static constexpr int HEARTBEAT_MAX_CONN = 2;
@@ -1397,6 +1399,8 @@ private:
     uint32_t hb_average_count = 0;
     uint32_t hb_index = 0;
 
+    uint32_t hb_back_count = 0;   ///< back samples, less credited rounds
+    uint32_t hb_back_last = 0;    ///< last real back ping time
     uint32_t hb_total_back = 0;
     uint32_t hb_min_back = UINT_MAX;
     uint32_t hb_max_back = 0;
@@ -1488,6 +1492,7 @@ private:
   }
   void heartbeat();
   void heartbeat_check();
+  void note_peer_traffic(Message *m);
   void heartbeat_entry();
   void need_heartbeat_peer_update();
 
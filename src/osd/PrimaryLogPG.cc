@@ -2255,6 +2255,10 @@ void PrimaryLogPG::do_op(OpRequestRef& op)
 
   dout(25) << __func__ << " oi " << obc->obs.oi << dendl;
 
+  if (r == 0 && !write_ordered && maybe_do_fast_read(op, obc)) {
+    return;
+  }
+
   OpContext *ctx = new OpContext(op, m->get_reqid(), &m->ops, obc, this);
 
   if (m->has_flag(CEPH_OSD_FLAG_SKIPRWLOCKS)) {
@@ -2335,6 +2339,109 @@ void PrimaryLogPG::do_op(OpRequestRef& op)
   maybe_force_recovery();
 }
 
+/*
+ * Serve a lone READ or STAT of a clean head object in a replicated pool
+ * directly, without building an OpContext or walking do_osd_ops().  No
+ * obc lock is taken: the pg lock is held throughout and we only proceed
+ * if a read lock could have been granted, so no write can be in flight.
+ * Anything unusual, including any error, returns false and the op goes
+ * through the normal path.
+ */
+bool PrimaryLogPG::maybe_do_fast_read(OpRequestRef& op, ObjectContextRef& obc)
+{
+  if (!cct->_conf->osd_fast_read_path) {
+    return false;
+  }
+  auto m = op->get_req<MOSDOp>();
+  if (m->ops.size() != 1 ||
+      op->may_write() ||
+      op->may_cache() ||
+      pool.info.is_erasure() ||
+      m->get_snapid() != CEPH_NOSNAP ||
+      (m->get_flags() & (CEPH_OSD_FLAG_FLUSH |
+			 CEPH_OSD_FLAG_SKIPRWLOCKS |
+			 CEPH_OSD_FLAG_IGNORE_CACHE))) {
+    return false;
+  }
+  const object_info_t& oi = obc->obs.oi;
+  if (!obc->obs.exists ||
+      oi.is_whiteout() ||
+      oi.is_lost() ||
+      oi.has_manifest() ||
+      oi.soid.snap != CEPH_NOSNAP ||
+      obc->rwstate.waiters > 0 ||
+      (obc->rwstate.state != RWState::RWNONE &&
+       obc->rwstate.state != RWState::RWREAD)) {
+    return false;
+  }
+
+  OSDOp& osd_op = const_cast<MOSDOp*>(m)->ops[0];
+  ceph_osd_op& rop = osd_op.op;
+  uint64_t off = 0;
+  uint64_t len = 0;
+  object_stat_sum_t delta;
+  switch (rop.op) {
+  case CEPH_OSD_OP_READ:
+    {
+      // leave truncation and its -1 munging to do_read()
+      if (rop.extent.truncate_seq > oi.truncate_seq) {
+	return false;
+      }
+      off = rop.extent.offset;
+      len = rop.extent.length ? rop.extent.length : oi.size;
+      if (off >= oi.size) {
+	len = 0;
+      } else if (off + len > oi.size) {
+	len = oi.size - off;
+      }
+      bufferlist bl;
+      if (len) {
+	int r = pgbackend->objects_read_sync(
+	  oi.soid, off, len, rop.flags, &bl);
+	if (r < 0) {
+	  // let do_read() deal with repair
+	  return false;
+	}
+	if (off == 0 && (uint64_t)r == oi.size && oi.is_data_digest() &&
+	    oi.data_digest != bl.crc32c(-1)) {
+	  return false;
+	}
+	len = r;
+      }
+      delta.num_rd++;
+      delta.num_rd_kb += shift_round_up(len, 10);
+      rop.extent.length = len;
+      osd_op.outdata.claim(bl);
+    }
+    break;
+  case CEPH_OSD_OP_STAT:
+    encode(oi.size, osd_op.outdata);
+    encode(oi.mtime, osd_op.outdata);
+    delta.num_rd++;
+    break;
+  default:
+    return false;
+  }
+  osd_op.rval = 0;
+
+  dout(20) << __func__ << " " << oi.soid << " " << osd_op << dendl;
+  op->mark_started();
+  unstable_stats.add(delta);
+
+  MOSDOpReply *reply = new MOSDOpReply(m, 0, get_osdmap_epoch(), 0, false);
+  reply->get_header().data_off = off;
+  reply->set_reply_versions(eversion_t(), oi.user_version);
+  reply->add_flags(CEPH_OSD_FLAG_ACK | CEPH_OSD_FLAG_ONDISK);
+  log_op_stats(*op, 0, osd_op.outdata.length());
+  publish_stats_to_osd();
+  osd->send_message_osd_client(reply, m->get_connection());
+
+  osd->logger->inc(l_osd_op_r_fast);
+  osd->logger->tinc(l_osd_op_r_fast_lat,
+		    ceph_clock_now() - op->get_dequeued_time());
+  return true;
+}
+
 PrimaryLogPG::cache_result_t PrimaryLogPG::maybe_handle_manifest_detail(
   OpRequestRef op,
   bool write_ordered,
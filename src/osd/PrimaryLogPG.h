@@ -1527,6 +1527,7 @@ public:
     OpRequestRef& op,
     ThreadPool::TPHandle &handle) override;
   void do_op(OpRequestRef& op);
+  bool maybe_do_fast_read(OpRequestRef& op, ObjectContextRef& obc);
   void record_write_error(OpRequestRef op, const hobject_t &soid,
 			  MOSDOpReply *orig_reply, int r,
 			  OpContext *ctx_for_op_returns=nullptr);
@@ -151,6 +151,10 @@ struct Session : public RefCountedObject {
   int peer = -1;
   HeartbeatStampsRef stamps;
 
+  // for cluster connections from other OSDs: when traffic on this session
+  // was last credited to the peer's heartbeat (see OSD::note_peer_traffic)
+  std::atomic<ceph::mono_time> last_hb_credit = {ceph::mono_time()};
+
   entity_addr_t& get_peer_socket_addr() {
     return socket_addr;
   }
@@ -71,6 +71,12 @@ PerfCounters *build_osd_logger(CephContext *cct) {
   osd_plb.add_time_avg(
     l_osd_op_r_prepare_lat, "op_r_prepare_latency",
     "Latency of read operations (excluding queue time and wait for finished)");
+  osd_plb.add_u64_counter(
+    l_osd_op_r_fast, "op_r_fast",
+    "Client read operations served by the fast read path");
+  osd_plb.add_time_avg(
+    l_osd_op_r_fast_lat, "op_r_fast_latency",
+    "Latency of fast path read operations (excluding queue time)");
   osd_plb.add_u64_counter(
     l_osd_op_w, "op_w", "Client write operations");
   osd_plb.add_u64_counter(
@@ -186,6 +192,9 @@ PerfCounters *build_osd_logger(CephContext *cct) {
     PerfCountersBuilder::PRIO_USEFUL);
   osd_plb.add_u64(
     l_osd_hb_to, "heartbeat_to_peers", "Heartbeat (ping) peers we send to");
+  osd_plb.add_u64_counter(
+    l_osd_hb_piggyback, "heartbeat_piggybacked",
+    "Back heartbeat pings skipped thanks to cluster replies from the peer");
   osd_plb.add_u64_counter(l_osd_map, "map_messages", "OSD map messages");
   osd_plb.add_u64_counter(l_osd_mape, "map_message_epochs", "OSD map epochs");
   osd_plb.add_u64_counter(
@@ -20,6 +20,8 @@ enum {
   l_osd_op_r_lat_outb_hist,
   l_osd_op_r_process_lat,
   l_osd_op_r_prepare_lat,
+  l_osd_op_r_fast,
+  l_osd_op_r_fast_lat,
   l_osd_op_w,
   l_osd_op_w_inb,
   l_osd_op_w_lat,
@@ -68,6 +70,7 @@ enum {
   l_osd_pg_stray,
   l_osd_pg_removing,
   l_osd_hb_to,
+  l_osd_hb_piggyback,
   l_osd_map,
   l_osd_mape,
   l_osd_mape_dup,
@@ -2932,7 +2932,33 @@ int Objecter::_calc_target(op_target_t *t, Connection *con, bool any_change)
     } else {
       int osd;
       bool read = is_read && !is_write;
-      if (read && (t->flags & CEPH_OSD_FLAG_BALANCE_READS)) {
+      if (read && (t->flags & CEPH_OSD_FLAG_BALANCE_READS) &&
+	  balance_reads_by_load) {
+	// pick the replica with the least observed load; start at a
+	// random rank so that ties are spread out.
+	int start = rand() % acting.size();
+	int best = -1;
+	uint64_t best_load = 0;
+	for (unsigned i = 0; i < acting.size(); ++i) {
+	  int p = (start + i) % acting.size();
+	  uint64_t load = 0;
+	  if (auto s = osd_sessions.find(acting[p]); s != osd_sessions.end()) {
+	    load = s->second->get_read_load();
+	  }
+	  ldout(cct, 20) << __func__ << " balance: rank " << p
+			 << " osd." << acting[p]
+			 << " load " << load << dendl;
+	  if (best < 0 || load < best_load) {
+	    best = p;
+	    best_load = load;
+	  }
+	}
+	if (best)
+	  t->used_replica = true;
+	osd = acting[best];
+	ldout(cct, 10) << " chose least loaded osd." << osd << " of " << acting
+		       << dendl;
+      } else if (read && (t->flags & CEPH_OSD_FLAG_BALANCE_READS)) {
 	int p = rand() % acting.size();
 	if (p)
 	  t->used_replica = true;
@@ -2997,6 +3023,7 @@ void Objecter::_session_op_assign(OSDSession *to, Op *op)
   get_session(to);
   op->session = to;
   to->ops[op->tid] = op;
+  ++to->num_ops_inflight;
 
   if (to->is_homeless()) {
     num_homeless_ops++;
@@ -3015,6 +3042,7 @@ void Objecter::_session_op_remove(OSDSession *from, Op *op)
   }
 
   from->ops.erase(op->tid);
+  --from->num_ops_inflight;
   put_session(from);
   op->session = NULL;
 
@@ -3175,6 +3203,7 @@ MOSDOp *Objecter::_prepare_osd_op(Op *op)
 
   op->target.paused = false;
   op->stamp = ceph::coarse_mono_clock::now();
+  op->sent_stamp = ceph::mono_clock::now();
 
   hobject_t hobj = op->target.get_hobj();
   MOSDOp *m = new MOSDOp(client_inc, op->tid,
@@ -3455,6 +3484,12 @@ void Objecter::handle_osd_op_reply(MOSDOpReply *m)
     return;
   }
 
+  if (balance_reads_by_load &&
+      (op->target.flags & CEPH_OSD_FLAG_READ) &&
+      !(op->target.flags & CEPH_OSD_FLAG_WRITE)) {
+    s->note_read_latency(ceph::mono_clock::now() - op->sent_stamp);
+  }
+
   sul.unlock();
 
   if (op->objver)
@@ -4962,6 +4997,22 @@ Objecter::OSDSession::~OSDSession()
   ceph_assert(command_ops.empty());
 }
 
+void Objecter::OSDSession::note_read_latency(ceph::timespan lat)
+{
+  // exponentially weighted moving average, 1/8 weight for each new sample
+  uint64_t us = std::chrono::duration_cast<std::chrono::microseconds>(lat).count();
+  uint64_t avg = read_lat_avg_us;
+  read_lat_avg_us = avg ? (avg * 7 + us) / 8 : us;
+}
+
+uint64_t Objecter::OSDSession::get_read_load() const
+{
+  // expected wait for a new op: everything already queued to this osd
+  // plus the new one, at the recently observed read latency.  osds we
+  // have no samples for yet look cheap, so they get probed.
+  return (num_ops_inflight + 1) * std::max<uint64_t>(read_lat_avg_us, 1);
+}
+
 Objecter::Objecter(CephContext *cct_, Messenger *m, MonClient *mc,
 		   Finisher *fin,
 		   double mon_timeout,
@@ -4975,7 +5026,8 @@ Objecter::Objecter(CephContext *cct_, Messenger *m, MonClient *mc,
   op_throttle_bytes(cct, "objecter_bytes",
 		    cct->_conf->objecter_inflight_op_bytes),
   op_throttle_ops(cct, "objecter_ops", cct->_conf->objecter_inflight_ops),
-  retry_writes_after_first_reply(cct->_conf->objecter_retry_writes_after_first_reply)
+  retry_writes_after_first_reply(cct->_conf->objecter_retry_writes_after_first_reply),
+  balance_reads_by_load(cct->_conf->objecter_balance_reads_by_load)
 {}
 
 Objecter::~Objecter()
@@ -15,6 +15,7 @@
 #ifndef CEPH_OBJECTER_H
 #define CEPH_OBJECTER_H
 
+#include <atomic>
 #include <condition_variable>
 #include <list>
 #include <map>
@@ -1477,6 +1478,7 @@ public:
     epoch_t *reply_epoch;
 
     ceph::coarse_mono_time stamp;
+    ceph::mono_time sent_stamp; ///< precise send time, for read latency
 
     epoch_t map_dne_bound;
 
@@ -1961,6 +1963,14 @@ public:
 
     bool is_homeless() { return (osd == -1); }
 
+    // load estimate used to balance reads across replicas; these are
+    // read without the session lock from _calc_target()
+    std::atomic<uint32_t> num_ops_inflight = {0};
+    std::atomic<uint64_t> read_lat_avg_us = {0};
+
+    void note_read_latency(ceph::timespan lat);
+    uint64_t get_read_load() const;
+
     unique_completion_lock get_lock(object_t& oid);
   };
   std::map<int,OSDSession*> osd_sessions;
@@ -3145,6 +3155,7 @@ public:
 private:
   epoch_t epoch_barrier = 0;
   bool retry_writes_after_first_reply;
+  bool balance_reads_by_load;
 public:
   void set_epoch_barrier(epoch_t epoch);
 
@@ -22,6 +22,7 @@
 #include <limits.h>
 #include <errno.h>
 #include <sys/uio.h>
+#include <thread>
 
 #include "include/buffer.h"
 #include "include/buffer_raw.h"
@@ -149,6 +150,88 @@ TEST(Buffer, BenchAlloc) {
   bench_buffer_alloc(4, 1000000);
 }
 
+TEST(Buffer, ThreadPool) {
+  auto pooled = [] {
+    return mempool::get_pool(mempool::mempool_buffer_pool).allocated_bytes();
+  };
+  const auto base = pooled();
+  buffer::set_pool_thread_max_bytes(1 << 20);
+  {
+    char *data;
+    {
+      bufferptr p(buffer::create_aligned(64 << 10, CEPH_PAGE_SIZE));
+      data = p.c_str();
+    }
+    EXPECT_EQ(base + (64 << 10), pooled());
+    // same size class, smaller alignment: the freed block is reused
+    bufferptr p(buffer::create_aligned(60 << 10, sizeof(size_t)));
+    EXPECT_EQ(data, p.c_str());
+    // the rounding slack stays accounted while the buffer is in use
+    EXPECT_EQ(base + (4 << 10), pooled());
+    EXPECT_EQ(60u << 10, p.length());
+  }
+  {
+    // rounding 33K up to 64K would waste too much; not pooled
+    { bufferptr p(buffer::create_aligned(33 << 10, CEPH_PAGE_SIZE)); }
+    EXPECT_EQ(base + (64 << 10), pooled());
+  }
+  {
+    // over the per-thread limit, freed blocks go back to the allocator
+    { bufferptr p(buffer::create_aligned(4 << 20, CEPH_PAGE_SIZE)); }
+    EXPECT_EQ(base + (64 << 10), pooled());
+  }
+  {
+    // lowering the limit trims the pool on the next get/put
+    {
+      std::vector<bufferptr> v;
+      for (int i = 0; i < 8; ++i) {
+	v.push_back(buffer::create_aligned(64 << 10, CEPH_PAGE_SIZE));
+      }
+    }
+    EXPECT_EQ(base + (8 << 16), pooled());
+    buffer::set_pool_thread_max_bytes(3 << 16);
+    { bufferptr p(buffer::create_aligned(4096, sizeof(size_t))); }
+    EXPECT_EQ(base + (3 << 16), pooled());
+  }
+  buffer::set_pool_thread_max_bytes(0);
+  {
+    // disabled: the pool is emptied and not refilled
+    { bufferptr p(buffer::create_aligned(64 << 10, CEPH_PAGE_SIZE)); }
+    EXPECT_EQ(base, pooled());
+  }
+}
+
+TEST(Buffer, ThreadPoolRemoteFree) {
+  auto pooled = [] {
+    return mempool::get_pool(mempool::mempool_buffer_pool).allocated_bytes();
+  };
+  const auto base = pooled();
+  buffer::set_pool_thread_max_bytes(1 << 20);
+  {
+    // freed by another thread: goes back to the allocating thread's pool
+    bufferptr p(buffer::create_aligned(64 << 10, CEPH_PAGE_SIZE));
+    char *data = p.c_str();
+    std::thread([p = std::move(p)]() mutable { p = bufferptr(); }).join();
+    EXPECT_EQ(base + (64 << 10), pooled());
+    bufferptr q(buffer::create_aligned(64 << 10, CEPH_PAGE_SIZE));
+    EXPECT_EQ(data, q.c_str());
+    EXPECT_EQ(base, pooled());
+  }
+  {
+    // the allocating thread is gone: freed to the allocator
+    bufferptr p;
+    std::thread([&p] {
+      p = bufferptr(buffer::create_aligned(64 << 10, CEPH_PAGE_SIZE));
+    }).join();
+    p = bufferptr();
+    // only q, back on our own free list
+    EXPECT_EQ(base + (64 << 10), pooled());
+  }
+  buffer::set_pool_thread_max_bytes(0);
+  { bufferptr p(buffer::create_aligned(4096, sizeof(size_t))); }
+  EXPECT_EQ(base, pooled());
+}
+
 TEST(BufferRaw, ostream) {
   bufferptr ptr(1);
   std::ostringstream stream;
@@ -577,6 +660,63 @@ TEST(BufferPtr, copy_in_bench) {
   }
 }
 
+TEST(BufferList, small_list_bench) {
+  // most messages and kv values are made of one to three ptrs, which
+  // share a raw; each one costs a ptr_node
+  bufferptr bp(buffer::create(4096));
+  bp.zero();
+  for (unsigned segments = 1; segments <= 3; ++segments) {
+    utime_t start = ceph_clock_now();
+    int count = 1000000;
+    for (int i = 0; i < count; ++i) {
+      bufferlist bl;
+      for (unsigned s = 0; s < segments; ++s) {
+	bl.append(bp, s * 100, 100);
+      }
+      bufferlist other;
+      other.claim_append(bl);
+    }
+    utime_t end = ceph_clock_now();
+    cout << count << " lists of " << segments << " ptrs built and freed in "
+	 << (end - start) << std::endl;
+  }
+}
+
+TEST(BufferList, decode_bench) {
+  // denc-style decode of small fields spread over a few ptrs, as e.g.
+  // MOSDOp's front
+  bufferlist bl;
+  for (int seg = 0; seg < 3; ++seg) {
+    bufferlist part;
+    for (int i = 0; i < 4096; ++i) {
+      encode((uint64_t)i, part);
+      encode((uint32_t)i, part);
+      encode((uint8_t)i, part);
+    }
+    bl.claim_append(part);
+  }
+  utime_t start = ceph_clock_now();
+  int count = 2000;
+  uint64_t sum = 0;
+  for (int i = 0; i < count; ++i) {
+    auto p = bl.cbegin();
+    while (!p.end()) {
+      uint64_t a;
+      uint32_t b;
+      uint8_t c;
+      p.copy(sizeof(a), (char*)&a);
+      p.copy(sizeof(b), (char*)&b);
+      p.copy(sizeof(c), (char*)&c);
+      sum += a + b + c;
+    }
+  }
+  utime_t end = ceph_clock_now();
+  EXPECT_EQ((uint64_t)count * 3 * (4095 * 4096 / 2 * 2 +
+				   (255 * 256 / 2) * 16), sum);
+  cout << count << " decodes of " << bl.length() << " bytes in "
+       << bl.get_num_buffers() << " ptrs in " << (end - start) << std::endl;
+}
+
 TEST(BufferPtr, append) {
   {
     bufferptr ptr;
@@ -0,0 +1,79 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+/*
+ * Ceph - scalable distributed file system
+ *
+ * This is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License version 2.1, as published by the Free Software
+ * Foundation.  See file COPYING.
+ *
+ */
+
+#include "common/ceph_context.h"
+#include "global/global_context.h"
+#include "messages/MClientCapsBatch.h"
+
+#include "gtest/gtest.h"
+
+static ref_t<MClientCaps> make_caps(unsigned i, unsigned xattr_len)
+{
+  auto m = ceph::make_message<MClientCaps>(
+    CEPH_CAP_OP_GRANT, inodeno_t(0x10000000000 + i), inodeno_t(1),
+    100 + i, i + 1, CEPH_CAP_PIN | CEPH_CAP_XATTR_SHARED, 0, 0, 0, 0);
+  m->set_tid(1000 + i);
+  m->size = 4096 * i;
+  if (xattr_len) {
+    m->head.xattr_version = i + 1;
+    m->xattrbl.append(std::string(xattr_len, 'a' + i));
+  }
+  return m;
+}
+
+static ref_t<MClientCapsBatch> round_trip(const ref_t<MClientCapsBatch>& batch)
+{
+  bufferlist bl;
+  encode_message(batch.get(), CEPH_FEATURES_ALL, bl);
+  auto p = bl.cbegin();
+  ref_t<Message> m(decode_message(g_ceph_context, 0, p), false);
+  if (!m || m->get_type() != CEPH_MSG_CLIENT_CAPS_BATCH)
+    return nullptr;
+  return ref_cast<MClientCapsBatch>(m);
+}
+
+TEST(MClientCapsBatch, Empty)
+{
+  auto batch = ceph::make_message<MClientCapsBatch>();
+  auto out = round_trip(batch);
+  ASSERT_TRUE(out);
+  ASSERT_TRUE(out->caps.empty());
+}
+
+TEST(MClientCapsBatch, RoundTrip)
+{
+  // mix caps with and without xattrs, so the middles have to stay with
+  // their own cap message
+  const unsigned xattr_lens[] = {16, 0, 4096, 1};
+  auto batch = ceph::make_message<MClientCapsBatch>();
+  for (unsigned i = 0; i < std::size(xattr_lens); i++)
+    batch->caps.push_back(make_caps(i, xattr_lens[i]));
+
+  auto out = round_trip(batch);
+  ASSERT_TRUE(out);
+  ASSERT_EQ(batch->caps.size(), out->caps.size());
+  for (unsigned i = 0; i < out->caps.size(); i++) {
+    const auto& in = batch->caps[i];
+    const auto& m = out->caps[i];
+    ASSERT_EQ(CEPH_MSG_CLIENT_CAPS, m->get_type());
+    ASSERT_EQ(in->get_header().version, m->get_header().version);
+    ASSERT_EQ(in->get_tid(), m->get_tid());
+    ASSERT_EQ(in->get_op(), m->get_op());
+    ASSERT_EQ(in->get_ino(), m->get_ino());
+    ASSERT_EQ(in->get_caps(), m->get_caps());
+    ASSERT_EQ(in->get_seq(), m->get_seq());
+    ASSERT_EQ(in->size, m->size);
+    ASSERT_EQ(in->head.xattr_version, m->head.xattr_version);
+    ASSERT_EQ(xattr_lens[i], m->xattrbl.length());
+    ASSERT_TRUE(in->xattrbl.contents_equal(m->xattrbl));
+  }
+}
@@ -0,0 +1,107 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+/*
+ * Ceph - scalable distributed file system
+ *
+ * This is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License version 2.1, as published by the Free Software
+ * Foundation.  See file COPYING.
+ *
+ */
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "mds/mdstypes.h"
+#include "mds/MDBalancer.h"
+
+#include "gtest/gtest.h"
+
+using bal_clock = MDBalancer::clock;
+
+static fnode_t make_fnode(int64_t files, int64_t subdirs,
+			  int64_t rfiles, int64_t rsubdirs)
+{
+  fnode_t f;
+  f.fragstat.nfiles = files;
+  f.fragstat.nsubdirs = subdirs;
+  f.rstat.rfiles = rfiles;
+  f.rstat.rsubdirs = rsubdirs;
+  return f;
+}
+
+TEST(MDBalancer, ExportCostCoversSubtree)
+{
+  // 3 direct entries, but 1010 inodes nested underneath
+  auto f = make_fnode(2, 1, 1000, 10);
+  ASSERT_DOUBLE_EQ(10.1, MDBalancer::subtree_export_cost(f, 0.01));
+  ASSERT_DOUBLE_EQ(0, MDBalancer::subtree_export_cost(f, 0));
+
+  // rstat not propagated yet: fall back to the direct entries
+  auto g = make_fnode(4, 1, 0, 0);
+  ASSERT_DOUBLE_EQ(5, MDBalancer::subtree_export_cost(g, 1));
+}
+
+TEST(MDBalancer, ExtrapolateLoad)
+{
+  auto t0 = bal_clock::now();
+  MDBalancer::load_sample_t s;
+
+  // no history yet
+  ASSERT_DOUBLE_EQ(100, MDBalancer::extrapolate_load(&s, 100, t0, 10));
+  // same round: no slope, sample kept
+  ASSERT_DOUBLE_EQ(150, MDBalancer::extrapolate_load(
+		     &s, 150, t0 + std::chrono::milliseconds(100), 10));
+  ASSERT_DOUBLE_EQ(100, s.load);
+
+  // +10/s for 10s ahead
+  auto t1 = t0 + std::chrono::seconds(10);
+  ASSERT_DOUBLE_EQ(300, MDBalancer::extrapolate_load(&s, 200, t1, 10));
+  ASSERT_DOUBLE_EQ(200, s.load);
+
+  // collapsing load never predicts below 0
+  auto t2 = t1 + std::chrono::seconds(10);
+  ASSERT_DOUBLE_EQ(0, MDBalancer::extrapolate_load(&s, 20, t2, 10));
+}
+
+// How find_exports() orders its smaller candidates: predicted load less
+// migration cost, over two balancer rounds.
+TEST(MDBalancer, RankSmallerCandidates)
+{
+  struct candidate_t {
+    std::string name;
+    double pop[2];   // load seen in round 1 and round 2
+    fnode_t fnode;
+    MDBalancer::load_sample_t sample;
+    double score = 0;
+  };
+  std::vector<candidate_t> candidates = {
+    {"steady",  {100, 100}, make_fnode(10, 0, 10, 0)},
+    {"cooling", {150, 110}, make_fnode(10, 0, 10, 0)},
+    {"heating", {60, 90},   make_fnode(10, 0, 5990, 10)},
+    {"hot",     {60, 90},   make_fnode(10, 0, 10, 0)},
+  };
+  const double horizon = 10, cost_per_inode = 0.005;
+
+  auto now = bal_clock::now();
+  for (unsigned round = 0; round < 2; ++round) {
+    for (auto& c : candidates) {
+      c.score = MDBalancer::extrapolate_load(&c.sample, c.pop[round], now,
+					     horizon) -
+	MDBalancer::subtree_export_cost(c.fnode, cost_per_inode);
+    }
+    now += std::chrono::seconds(10);
+  }
+  std::sort(candidates.begin(), candidates.end(),
+	    [](const auto& a, const auto& b) { return a.score > b.score; });
+
+  std::vector<std::string> order;
+  for (const auto& c : candidates)
+    order.push_back(c.name);
+  // "hot" and "heating" grow at the same rate, but "heating" drags 6000
+  // inodes along; "cooling" is busiest now but on its way down
+  std::vector<std::string> expected = {"hot", "steady", "heating", "cooling"};
+  ASSERT_EQ(expected, order);
+}
@@ -0,0 +1,166 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+#include <string>
+
+#include <boost/container/static_vector.hpp>
+
+#include "gtest/gtest.h"
+#include "global/global_context.h"
+#include "include/buffer.h"
+#include "msg/async/frames_v2.h"
+
+using namespace ceph::msgr::v2;
+
+static ceph::bufferlist make_compressible(unsigned len, char seed)
+{
+  ceph::bufferlist bl;
+  std::string s;
+  for (unsigned i = 0; i < len; ++i) {
+    s.push_back(static_cast<char>(seed + i % 7));
+  }
+  bl.append(s);
+  return bl;
+}
+
+// what the receiver has once the segments of the frame are read
+static MessageFrame::rx_segments_t to_rx_segments(MessageFrame& frame)
+{
+  MessageFrame::rx_segments_t segments;
+  ceph_msg_header2 header{};
+  segments.emplace_back();
+  segments.back().append(reinterpret_cast<const char*>(&header),
+			 sizeof(header));
+  segments.push_back(frame.front());
+  segments.push_back(frame.middle());
+  segments.push_back(frame.data());
+  return segments;
+}
+
+class MessageFrameCompression : public ::testing::Test {
+public:
+  CompressorRef compressor;
+  std::array<CompressorRef, Compressor::COMP_ALG_LAST> rx_compressors;
+
+  void SetUp() override {
+    compressor = Compressor::create(g_ceph_context, "zlib");
+    ASSERT_TRUE(compressor);
+  }
+};
+
+TEST_F(MessageFrameCompression, RoundTrip) {
+  ceph_msg_header2 header{};
+  auto front = make_compressible(4096, 'a');
+  auto middle = make_compressible(100, 'm');  // below min_size
+  auto data = make_compressible(65536, 'd');
+
+  auto frame = MessageFrame::Encode(header, front, middle, data);
+  ASSERT_TRUE(frame.compress(*compressor, 1024, CEPH_MSGR2_SUPPORTED_FEATURES));
+  ASSERT_LT(frame.front().length(), front.length());
+  ASSERT_EQ(middle.length() + sizeof(compression_header_t),
+	    frame.middle().length());
+  ASSERT_LT(frame.data().length(), data.length());
+
+  auto segments = to_rx_segments(frame);
+  ASSERT_EQ(static_cast<int64_t>(front.length() + middle.length() +
+				  data.length()),
+	    MessageFrame::get_decompressed_length(segments, 1 << 20));
+  ASSERT_EQ(0, MessageFrame::decompress(g_ceph_context, segments,
+					rx_compressors));
+  ASSERT_TRUE(segments[SegmentIndex::Msg::FRONT].contents_equal(front));
+  ASSERT_TRUE(segments[SegmentIndex::Msg::MIDDLE].contents_equal(middle));
+  ASSERT_TRUE(segments[SegmentIndex::Msg::DATA].contents_equal(data));
+}
+
+// the preamble flags of the frame as it goes on the wire
+static __u8 onwire_flags(MessageFrame& frame)
+{
+  ceph::crypto::onwire::rxtx_t no_crypto;
+  auto bl = frame.get_buffer(no_crypto);
+  preamble_block_t preamble;
+  bl.begin().copy(sizeof(preamble), reinterpret_cast<char*>(&preamble));
+  return preamble.flags;
+}
+
+TEST_F(MessageFrameCompression, NotSentToPeerWithoutFeature) {
+  ceph_msg_header2 header{};
+  auto front = make_compressible(4096, 'a');
+  auto data = make_compressible(65536, 'd');
+  // no features, and upstream's REVISION_1 (bit 0) and COMPRESSION
+  // (bit 1), which mean something else there
+  const uint64_t peers[] = {0, 1ull << 0, 1ull << 1, 3,
+			    ~CEPH_MSGR2_FEATURE_COMPRESSION};
+  for (uint64_t peer_features : peers) {
+    auto frame = MessageFrame::Encode(header, front, {}, data);
+    ASSERT_FALSE(frame.compress(*compressor, 1024, peer_features));
+    ASSERT_TRUE(frame.front().contents_equal(front));
+    ASSERT_TRUE(frame.data().contents_equal(data));
+    ASSERT_EQ(0, onwire_flags(frame) & FRAME_EARLY_FLAGS_COMPRESSED);
+  }
+
+  auto frame = MessageFrame::Encode(header, front, {}, data);
+  ASSERT_TRUE(frame.compress(*compressor, 1024,
+			     CEPH_MSGR2_FEATURE_COMPRESSION));
+  ASSERT_NE(0, onwire_flags(frame) & FRAME_EARLY_FLAGS_COMPRESSED);
+}
+
+TEST_F(MessageFrameCompression, NothingToCompress) {
+  ceph_msg_header2 header{};
+  auto front = make_compressible(100, 'a');
+  auto frame = MessageFrame::Encode(header, front, {}, {});
+  ASSERT_FALSE(frame.compress(*compressor, 1024, CEPH_MSGR2_SUPPORTED_FEATURES));
+  ASSERT_TRUE(frame.front().contents_equal(front));
+}
+
+TEST_F(MessageFrameCompression, OversizedRawLengthRejected) {
+  ceph_msg_header2 header{};
+  auto data = make_compressible(65536, 'd');
+  auto frame = MessageFrame::Encode(header, {}, {}, data);
+  ASSERT_TRUE(frame.compress(*compressor, 1024, CEPH_MSGR2_SUPPORTED_FEATURES));
+
+  // the limit is checked against the headers, before decompressing
+  auto segments = to_rx_segments(frame);
+  ASSERT_EQ(-EMSGSIZE, MessageFrame::get_decompressed_length(segments,
+							      65535));
+  ASSERT_EQ(65536, MessageFrame::get_decompressed_length(segments, 65536));
+
+  // a header claiming a huge raw length is rejected as such
+  auto& seg = segments[SegmentIndex::Msg::DATA];
+  compression_header_t comp;
+  seg.begin().copy(sizeof(comp), reinterpret_cast<char*>(&comp));
+  comp.raw_length = 1u << 31;
+  seg.begin().copy_in(sizeof(comp), reinterpret_cast<const char*>(&comp));
+  ASSERT_EQ(-EMSGSIZE, MessageFrame::get_decompressed_length(segments,
+							      256 << 20));
+}
+
+TEST_F(MessageFrameCompression, RawLengthMismatchRejected) {
+  ceph_msg_header2 header{};
+  auto data = make_compressible(65536, 'd');
+  auto frame = MessageFrame::Encode(header, {}, {}, data);
+  ASSERT_TRUE(frame.compress(*compressor, 1024, CEPH_MSGR2_SUPPORTED_FEATURES));
+
+  auto segments = to_rx_segments(frame);
+  auto& seg = segments[SegmentIndex::Msg::DATA];
+  compression_header_t comp;
+  seg.begin().copy(sizeof(comp), reinterpret_cast<char*>(&comp));
+  comp.raw_length = 4096;
+  seg.begin().copy_in(sizeof(comp), reinterpret_cast<const char*>(&comp));
+  ASSERT_EQ(4096, MessageFrame::get_decompressed_length(segments, 65536));
+  ASSERT_EQ(-EINVAL, MessageFrame::decompress(g_ceph_context, segments,
+					      rx_compressors));
+}
+
+TEST_F(MessageFrameCompression, MalformedHeaderRejected) {
+  MessageFrame::rx_segments_t segments(4);
+  segments[SegmentIndex::Msg::FRONT].append("abc", 3);  // too short
+  ASSERT_EQ(-EINVAL, MessageFrame::get_decompressed_length(segments, 1024));
+
+  compression_header_t comp;
+  comp.raw_length = 10;
+  comp.algorithm = Compressor::COMP_ALG_LAST;
+  segments[SegmentIndex::Msg::FRONT].clear();
+  segments[SegmentIndex::Msg::FRONT].append(
+    reinterpret_cast<const char*>(&comp), sizeof(comp));
+  ASSERT_EQ(-EINVAL, MessageFrame::get_decompressed_length(segments, 1024));
+}
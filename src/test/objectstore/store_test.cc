@@ -6193,6 +6193,65 @@ TEST_P(StoreTest, BluestoreOnOffCSumTest) {
     ASSERT_EQ(r, 0);
   }
 }
+
+TEST_P(StoreTest, BluestoreVerifyCSumsTest) {
+  if (string(GetParam()) != "bluestore")
+    return;
+  SetVal(g_conf(), "bluestore_csum_type", "crc32c");
+  g_conf().apply_changes(nullptr);
+
+  int r;
+  coll_t cid;
+  ghobject_t hoid(hobject_t(sobject_t("Object 1", CEPH_NOSNAP)));
+  ghobject_t hoid2(hobject_t(sobject_t("Object 2", CEPH_NOSNAP)));
+  size_t block_size = 64*1024;
+  auto ch = store->create_new_collection(cid);
+  {
+    ObjectStore::Transaction t;
+    t.create_collection(cid, 0);
+    bufferlist bl;
+    bl.append(std::string(block_size, 'a'));
+    t.write(cid, hoid, 0, bl.length(), bl);
+    r = queue_transaction(store, ch, std::move(t));
+    ASSERT_EQ(r, 0);
+  }
+  {
+    r = store->verify_csums(ch, hoid, 0, block_size);
+    ASSERT_EQ((int)block_size, r);
+    r = store->verify_csums(ch, hoid, block_size / 2, block_size);
+    ASSERT_EQ((int)block_size / 2, r);
+    r = store->verify_csums(ch, hoid, block_size, block_size);
+    ASSERT_EQ(0, r);
+    r = store->verify_csums(ch, hoid2, 0, block_size);
+    ASSERT_EQ(-ENOENT, r);
+  }
+  {
+    SetVal(g_conf(), "bluestore_csum_type", "none");
+    g_conf().apply_changes(nullptr);
+
+    ObjectStore::Transaction t;
+    bufferlist bl;
+    bl.append(std::string(block_size, 'b'));
+    t.write(cid, hoid2, 0, bl.length(), bl);
+    r = queue_transaction(store, ch, std::move(t));
+    ASSERT_EQ(r, 0);
+
+    r = store->verify_csums(ch, hoid2, 0, block_size);
+    ASSERT_EQ(-EOPNOTSUPP, r);
+
+    SetVal(g_conf(), "bluestore_csum_type", "crc32c");
+    g_conf().apply_changes(nullptr);
+  }
+  {
+    ObjectStore::Transaction t;
+    t.remove(cid, hoid);
+    t.remove(cid, hoid2);
+    t.remove_collection(cid);
+    cerr << "Cleaning" << std::endl;
+    r = queue_transaction(store, ch, std::move(t));
+    ASSERT_EQ(r, 0);
+  }
+}
 #endif
 
 INSTANTIATE_TEST_SUITE_P(
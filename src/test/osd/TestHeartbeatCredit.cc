@@ -0,0 +1,135 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+/*
+ * Ceph - scalable distributed file system
+ *
+ * This is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License version 2.1, as published by the Free Software
+ * Foundation.  See file COPYING.
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "osd/HeartbeatCredit.h"
+
+namespace {
+
+// Drives HeartbeatCredit the way OSD::heartbeat() and handle_osd_ping()
+// do: one round per second, replies 1ms after the send.
+struct HeartbeatSim {
+  HeartbeatCredit credit;
+  utime_t now{100, 0};
+  utime_t last_tx;
+  utime_t last_rx_back;
+  bool have_front = true;
+  unsigned back_pings = 0;
+  unsigned back_samples = 0;
+
+  // one heartbeat round; @p acked: the peer answered one of our cluster
+  // requests during the previous interval
+  bool round(bool acked) {
+    if (acked)
+      credit.note_ack(now - utime_t(0, 500000000));
+    bool skip = credit.can_credit(last_tx, last_rx_back, have_front);
+    utime_t stamp = now;
+    last_tx = now;
+    credit.sent(stamp, skip);
+    if (skip) {
+      last_rx_back = std::max(last_rx_back, credit.get_last_ack());
+    } else {
+      ++back_pings;
+      last_rx_back = stamp + utime_t(0, 1000000);
+    }
+    // all replies in
+    if (!credit.was_credited(stamp))
+      ++back_samples;
+    now += utime_t(1, 0);
+    return skip;
+  }
+};
+
+}
+
+TEST(HeartbeatCredit, NoAcksNoCredit)
+{
+  HeartbeatSim sim;
+  for (int i = 0; i < 10; ++i)
+    ASSERT_FALSE(sim.round(false));
+  ASSERT_EQ(10u, sim.back_pings);
+  ASSERT_EQ(10u, sim.back_samples);
+}
+
+TEST(HeartbeatCredit, FirstRoundNeedsRealBackPing)
+{
+  HeartbeatSim sim;
+  // an ack before any back reply is not enough
+  ASSERT_FALSE(sim.round(true));
+  ASSERT_TRUE(sim.round(true));
+}
+
+TEST(HeartbeatCredit, NoFrontNoCredit)
+{
+  HeartbeatSim sim;
+  sim.have_front = false;
+  for (int i = 0; i < 10; ++i)
+    ASSERT_FALSE(sim.round(true));
+}
+
+TEST(HeartbeatCredit, AckedRoundsAreCreditedWithRealPingsInBetween)
+{
+  HeartbeatSim sim;
+  ASSERT_FALSE(sim.round(false));
+  unsigned skipped = 0;
+  unsigned run = 0;
+  for (int i = 0; i < 40; ++i) {
+    if (sim.round(true)) {
+      ++skipped;
+      ++run;
+      ASSERT_LE(run, HeartbeatCredit::MAX_CONSECUTIVE);
+    } else {
+      run = 0;
+    }
+  }
+  ASSERT_EQ(30u, skipped);
+  ASSERT_EQ(11u, sim.back_pings);
+  // credited rounds leave no back sample; real ones always do
+  ASSERT_EQ(sim.back_pings, sim.back_samples);
+}
+
+TEST(HeartbeatCredit, BackPingsResumeWhenAcksStop)
+{
+  HeartbeatSim sim;
+  ASSERT_FALSE(sim.round(false));
+  ASSERT_TRUE(sim.round(true));
+  ASSERT_TRUE(sim.round(true));
+  // the peer keeps sending us traffic but stops answering ours
+  ASSERT_FALSE(sim.round(false));
+  ASSERT_FALSE(sim.round(false));
+  ASSERT_TRUE(sim.round(true));
+}
+
+TEST(HeartbeatCredit, StaleAckDoesNotCredit)
+{
+  HeartbeatCredit credit;
+  utime_t last_rx_back(10, 0);
+  credit.note_ack(utime_t(11, 0));
+  ASSERT_TRUE(credit.can_credit(utime_t(10, 0), last_rx_back, true));
+  // acked before our last round went out
+  ASSERT_FALSE(credit.can_credit(utime_t(12, 0), last_rx_back, true));
+  // acks never go backwards
+  credit.note_ack(utime_t(9, 0));
+  ASSERT_EQ(utime_t(11, 0), credit.get_last_ack());
+}
+
+TEST(HeartbeatCredit, WasCreditedRetiresOlderRounds)
+{
+  HeartbeatCredit credit;
+  credit.sent(utime_t(1, 0), true);
+  credit.sent(utime_t(2, 0), true);
+  credit.sent(utime_t(3, 0), false);
+  // round 1 never completed; round 2 completing retires it
+  ASSERT_TRUE(credit.was_credited(utime_t(2, 0)));
+  ASSERT_FALSE(credit.was_credited(utime_t(1, 0)));
+  ASSERT_FALSE(credit.was_credited(utime_t(3, 0)));
+}